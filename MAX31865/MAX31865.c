@@ -29,18 +29,16 @@
  */
 
 #include "MAX31865.h"
-
-/*--------------Характеристики датчика типа PT100 и референсный резистор, подключенный к MAX31865------------*/
-#define MAX31865_PT100_R0 (double)100.0 //Сопротивление датчика PT100, при 0 °С
-#define MAX31865_R_REF (double)428.5 //Сопротивление референсного резистора, подключенного к MAX31865
-/*--------------Характеристики датчика типа PT100 и референсный резистор, подключенный к MAX31865------------*/
+#include "profiler.h"
+#include "trace.h"
+#include "fault_log.h"
+#include "clock_manager.h"
 
 /*-----------------------------------------Глобальные переменные---------------------------------------------*/
-float MAX31865_PT100_R = 0.0; //Глобальная переменная, определяющая сопротивление датчика PT100
-float MAX31865_PT100_T = 0.0; //Глобальная переменная, определяющая температуру датчика PT100
-float MAX31865_Correction_additive = 0.0f; //Калибровка смещения
-float MAX31865_Correction_multiplicative = 1.0f; //Калибровка наклона
-bool MAX31865_Sensor_Error = 0; //Глобальная переменная, определяющая неисправность датчика PT100
+struct MAX31865_SPI_Link MAX31865_SPI_Link = { 0b011, 72000000 / 16, 0xFF, 0 }; //Как в CMSIS_SPI1_init() на 72 MHz, пока не было подбора
+volatile uint8_t MAX31865_Fault_status = 0; //Регистр Fault Status последнего измерения (0 - нет ошибки)
+volatile uint32_t MAX31865_Sample_timestamp = 0; //Clock_Now() в момент окончания чтения последнего измерения (clock_manager.h)
+struct Trend_Channel Trend_Table[CHANNEL_COUNT]; //Прогноз выхода за пределы по каналам (pipeline.h), Enabled = false - выключен
 /*-----------------------------------------Глобальные переменные---------------------------------------------*/
 
 /*-------------------------------------------Для работы по spi-----------------------------------------------*/
@@ -69,7 +67,6 @@ void MAX31865_Init(SPI_TypeDef* SPI, uint8_t num_wires) {
 void MAX31865_Init(SPI_HandleTypeDef *hspi, uint8_t num_wires) {
 #endif
 
-	MAX31865_Sensor_Error = 0;
 	uint8_t MAX31865_Configuration_register_write[] = { 0x80, 0x00 };
 	if (num_wires == 2 || num_wires == 4) {
 		MAX31865_Configuration_register_write[1] = 0xC3;
@@ -88,6 +85,116 @@ void MAX31865_Init(SPI_HandleTypeDef *hspi, uint8_t num_wires) {
 
 }
 
+#if defined (USE_CMSIS)
+
+/*
+ **************************************************************************************************
+ *  @breif Запись и чтение регистров порогов неисправности (0x03..0x06) одним пакетом
+ *  @retval  Возвращает количество несовпадений прочитанного с записанным (0 - линия в порядке)
+ **************************************************************************************************
+ */
+static uint16_t MAX31865_SPI_Check_Pattern(SPI_TypeDef* SPI, const uint8_t* Pattern) {
+	uint8_t Write[5] = { 0x83, Pattern[0], Pattern[1], Pattern[2], Pattern[3] };
+	uint8_t Address = 0x03;
+	uint8_t Read[4] = { 0 };
+	uint16_t Errors = 0;
+
+	NSS_ON;
+	bool Status = CMSIS_SPI_Data_Transmit_8BIT(SPI, Write, 5, 10);
+	NSS_OFF;
+	NSS_ON;
+	Status = CMSIS_SPI_Data_Transmit_8BIT(SPI, &Address, 1, 10) && Status;
+	Status = CMSIS_SPI_Data_Receive_8BIT(SPI, Read, 4, 10) && Status;
+	NSS_OFF;
+
+	if (!Status) {
+		return 4;
+	}
+	for (uint8_t i = 0; i < 4; i++) {
+		uint8_t Mask = (i & 1) ? 0xFE : 0xFF; //Бит D0 младших байтов порогов не используется
+		if ((Read[i] ^ Pattern[i]) & Mask) {
+			Errors++;
+		}
+	}
+	return Errors;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Такт SPI1 (PCLK2) по текущим настройкам RCC
+ **************************************************************************************************
+ */
+static uint32_t MAX31865_SPI_PCLK(void) {
+	SystemCoreClockUpdate(); //HCLK из RCC->CFGR
+	return SystemCoreClock >> APBPrescTable[READ_BIT(RCC->CFGR, RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos];
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Подбор частоты SPI под конкретную линию (вызывать при старте после MAX31865_Init())
+ *  @attention Делитель BR перебирается от самого медленного (fPCLK/256) к быстрому, но не быстрее
+ *  MAX31865_SPI_MAX_HZ при текущей PCLK2 (из RCC). На каждом шаге MAX31865_SPI_TUNE_ROUNDS раз
+ *  пишутся и читаются обратно шаблоны в регистры порогов неисправности. Перебор останавливается
+ *  на первой ошибке, и берется последний прошедший шаг - на один медленнее ошибочного; если
+ *  прошли все шаги до предела datasheet - берется предел.
+ *  На PCLK2 = 72 MHz предел datasheet (5 MHz) - это fPCLK/16, тот же делитель, что ставит
+ *  CMSIS_SPI1_init(): тогда подбор ускорить шину не может, он только проверяет линию и при
+ *  ошибках замедляет ее. Быстрее делителя по умолчанию он выбирает при меньшей PCLK2.
+ *  По окончании пороги возвращаются в значения по умолчанию (0xFFFF / 0x0000).
+ *  Результат - в MAX31865_SPI_Link.
+ *  @param  *SPI - шина SPI
+ *  @retval  true - частота выбрана, false - ни один шаг не прошел (датчика нет), делитель не изменен
+ **************************************************************************************************
+ */
+bool MAX31865_SPI_Tune(SPI_TypeDef* SPI) {
+	static const uint8_t Patterns[][4] = {
+		{ 0xAA, 0x54, 0x55, 0xAA },
+		{ 0x55, 0xAA, 0xAA, 0x54 },
+		{ 0xFF, 0xFE, 0x00, 0x00 },
+		{ 0x00, 0x00, 0xFF, 0xFE },
+		{ 0x80, 0x02, 0x01, 0x80 },
+		{ 0x0F, 0xF0, 0xF0, 0x0E }
+	};
+	static const uint8_t Defaults[4] = { 0xFF, 0xFF, 0x00, 0x00 };
+	uint8_t Passed = 0xFF; //Самый быстрый прошедший BR
+	uint8_t Fastest = 0; //Самый быстрый BR в пределах datasheet
+	uint32_t PCLK = MAX31865_SPI_PCLK();
+
+	while (Fastest < 7 && (PCLK / (2UL << Fastest)) > MAX31865_SPI_MAX_HZ) {
+		Fastest++;
+	}
+
+	MAX31865_SPI_Link.Failed_prescaler = 0xFF;
+	MAX31865_SPI_Link.Errors = 0;
+	for (int8_t Prescaler = 7; Prescaler >= Fastest; Prescaler--) {
+		uint16_t Errors = 0;
+		CMSIS_SPI_Set_Prescaler(SPI, (uint8_t) Prescaler, 10);
+		for (uint8_t Round = 0; Round < MAX31865_SPI_TUNE_ROUNDS; Round++) {
+			for (uint8_t i = 0; i < sizeof(Patterns) / sizeof(Patterns[0]); i++) {
+				Errors += MAX31865_SPI_Check_Pattern(SPI, Patterns[i]);
+			}
+		}
+		if (Errors) {
+			MAX31865_SPI_Link.Failed_prescaler = (uint8_t) Prescaler;
+			MAX31865_SPI_Link.Errors = Errors;
+			break;
+		}
+		Passed = (uint8_t) Prescaler;
+	}
+
+	if (Passed == 0xFF) {
+		CMSIS_SPI_Set_Prescaler(SPI, MAX31865_SPI_Link.Prescaler, 10); //Оставляем как было
+		return false;
+	}
+	CMSIS_SPI_Set_Prescaler(SPI, Passed, 10);
+	MAX31865_SPI_Check_Pattern(SPI, Defaults);
+	MAX31865_SPI_Link.Prescaler = Passed;
+	MAX31865_SPI_Link.Frequency = PCLK / (2UL << Passed);
+	return true;
+}
+
+#endif
+
 /*
  **************************************************************************************************
  *  @breif Получить информацию о конфигурации модуля MAX31865 
@@ -127,20 +234,18 @@ uint8_t MAX31865_Configuration_info(SPI_HandleTypeDef *hspi) {
  *  @attention Просходит обращение к начальному адресу регистра памяти модуля и из него читаем 7 байт.
  *  В функцию также включена самодиагностика модуля, которая сообщит, если с датчиком будет что-то не так.
  *  @param  *SPI или *hspi - шина SPI
- *  @retval  Возвращает значение конфигурации.
- *  @attention Не удивляйтесь, если отправите при инициализации 0xC3, а получите 0xC1
- *  (См. datasheet MAX31865 стр. 14 "The fault status clear bit D1, self-clears to 0.")
+ *  @retval  Возвращает 15-битный код АЦП сопротивления (R = Code * R_REF / 32768).
+ *  Для контуров, работающих в кодах АЦП (см. pid_code_space.h), пересчет в double не нужен.
  **************************************************************************************************
  */
 
 #if defined (USE_CMSIS)
-double MAX31865_Get_Resistance(SPI_TypeDef* SPI) {
+RAMFUNC uint16_t MAX31865_Get_Code(SPI_TypeDef* SPI) {
 #elif defined (USE_HAL)
-double MAX31865_Get_Resistance(SPI_HandleTypeDef *hspi) {
+uint16_t MAX31865_Get_Code(SPI_HandleTypeDef *hspi) {
 #endif
 
 	uint8_t MAX31865_rx_buffer[7]; //буфер, куда будем складывать приходящие данные
-	double data; //переменная для вычислений
 
 	struct rx_data_MAX31865 {
 		uint16_t RTD_Resistance_Registers; //Регистры сопротивления
@@ -153,25 +258,39 @@ double MAX31865_Get_Resistance(SPI_HandleTypeDef *hspi) {
 
 	uint8_t MAX31865_start_address_of_the_poll = 0x01; //Адрес регистра, с которого начнем чтение данных
 
+	PROFILER_BEGIN(PROFILER_MAX31865_GET_CODE);
 	NSS_ON;
+	TRACE_EVENT(TRACE_CS_ASSERT, 0);
+	PROFILER_BEGIN(PROFILER_SPI_TX);
 #if defined (USE_CMSIS)
 	CMSIS_SPI_Data_Transmit_8BIT(SPI, &MAX31865_start_address_of_the_poll, 1, 100);
-	CMSIS_SPI_Data_Receive_8BIT(SPI,  MAX31865_rx_buffer, 7, 100);
 #elif defined (USE_HAL)
 	HAL_SPI_Transmit(hspi, &MAX31865_start_address_of_the_poll, 1, 100);
+#endif
+	PROFILER_END(PROFILER_SPI_TX);
+	PROFILER_BEGIN(PROFILER_SPI_RX);
+#if defined (USE_CMSIS)
+	CMSIS_SPI_Data_Receive_8BIT(SPI,  MAX31865_rx_buffer, 7, 100);
+#elif defined (USE_HAL)
 	HAL_SPI_Receive(hspi, MAX31865_rx_buffer, 7, 100);
 #endif
+	PROFILER_END(PROFILER_SPI_RX);
 	NSS_OFF
 	;
+	TRACE_EVENT(TRACE_CS_RELEASE, 0);
+	MAX31865_Sample_timestamp = Clock_Now(); //Отметка времени измерения (Reading.Timestamp)
 
 	MAX31865_receieve_data.RTD_Resistance_Registers = ((MAX31865_rx_buffer[0] << 8) | MAX31865_rx_buffer[1]) >> 1; //Данные регистров сопротивления
 	MAX31865_receieve_data.High_Fault_Threshold = ((MAX31865_rx_buffer[2] << 8) | MAX31865_rx_buffer[3]) >> 1; //Данные верхнего порого неисправности
 	MAX31865_receieve_data.Low_Fault_Threshold = (MAX31865_rx_buffer[4] << 8) | MAX31865_rx_buffer[5]; //Данные нижнего порога неисправности
 	MAX31865_receieve_data.Fault_Status = MAX31865_rx_buffer[6]; //Статус неисправности
+	MAX31865_Fault_status = MAX31865_receieve_data.Fault_Status;
 	if (MAX31865_receieve_data.Fault_Status > 0x00) {
 
 		/*--------------Здесь Ваши действия по реагированию на ошибку датчика---------------*/
-		MAX31865_Sensor_Error = 1;
+		//Расшифровка по битам и журнал - Fault_Log_Record() в MAX31865_Measure() (см. fault_log.h).
+		//При работе напрямую через MAX31865_Get_Code() - Fault_Log_Record(канал, MAX31865_Fault_status).
+		TRACE_EVENT(TRACE_FAULT, 0);
 
 		/*----Автоматический сброс ошибки----*/
 #if defined (USE_CMSIS)
@@ -179,7 +298,6 @@ double MAX31865_Get_Resistance(SPI_HandleTypeDef *hspi) {
 #elif defined (USE_HAL)
 		MAX31865_Init(hspi, 3);
 #endif		
-		MAX31865_Sensor_Error = 0;
 		/*----Автоматический сброс ошибки----*/
 
 		//Так можно сбросить ошибку, проинициализировав датчик заново.
@@ -187,12 +305,73 @@ double MAX31865_Get_Resistance(SPI_HandleTypeDef *hspi) {
 		//До прихода оператора, установка находится в ошибке, все управляющие узлы должны отключаться.
 	}
 
-	data = ((double) MAX31865_receieve_data.RTD_Resistance_Registers * MAX31865_R_REF ) / (double) 32768.0;
-	return data;
+	PROFILER_END(PROFILER_MAX31865_GET_CODE);
+	return MAX31865_receieve_data.RTD_Resistance_Registers;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Получить сопротивление датчика
+ *  @param  *SPI или *hspi - шина SPI
+ *  @retval  Возвращает сопротивление датчика, Ом
+ **************************************************************************************************
+ */
+
+#if defined (USE_CMSIS)
+RAMFUNC double MAX31865_Get_Resistance(SPI_TypeDef* SPI) {
+	uint16_t Code = MAX31865_Get_Code(SPI);
+#elif defined (USE_HAL)
+double MAX31865_Get_Resistance(SPI_HandleTypeDef *hspi) {
+	uint16_t Code = MAX31865_Get_Code(hspi);
+#endif
+	return ((double) Code * MAX31865_R_REF ) / (double) 32768.0;
 }
 
-double MAX31865_Get_Temperature(double Resistance) {
+RAMFUNC double MAX31865_Get_Temperature(double Resistance) {
+	PROFILER_BEGIN(PROFILER_CONVERSION);
 	double Temperature = Get_Temperature_PT(Resistance, PT100_R0, 0);
+	PROFILER_END(PROFILER_CONVERSION);
+	TRACE_EVENT(TRACE_CONVERSION_DONE, 0);
 	return Temperature;
 }
 
+/*
+ **************************************************************************************************
+ *  @breif Полное измерение канала с публикацией результата (см. reading.h)
+ *  @attention Код, сопротивление с калибровкой, температура, статус ошибки и отметка времени
+ *  публикуются одной записью - читатели (в том числе прерывания) не увидят смесь двух измерений.
+ *  @param  *SPI или *hspi - шина SPI
+ *  @param  Channel - номер канала (записи в reading.c)
+ *  @param  *Reading - сюда же кладется копия измерения (для вызывающего, без повторного чтения)
+ **************************************************************************************************
+ */
+
+#if defined (USE_CMSIS)
+void MAX31865_Measure(SPI_TypeDef* SPI, uint8_t Channel, struct Reading* Reading) {
+	Reading->Code = MAX31865_Get_Code(SPI);
+#elif defined (USE_HAL)
+void MAX31865_Measure(SPI_HandleTypeDef *hspi, uint8_t Channel, struct Reading* Reading) {
+	Reading->Code = MAX31865_Get_Code(hspi);
+#endif
+	Reading->Status = MAX31865_Fault_status;
+	Reading->Timestamp = MAX31865_Sample_timestamp;
+	MAX31865_Publish(Channel, Reading);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Пересчет и публикация измерения канала, у которого уже есть код, статус и время
+ *  @attention Общая часть MAX31865_Measure() и синхронного опроса (max31865_sync.h).
+ *  Сам пересчет - Pipeline_Publish() (pipeline.h), тот же код гоняет host/replay.c на ПК.
+ *  После пересчета - шаг прогноза канала (Trend_Table, команда "trend").
+ *  @param  Channel - номер канала
+ *  @param  *Reading - заполнены Code, Status, Timestamp; остальные поля заполняются здесь
+ **************************************************************************************************
+ */
+void MAX31865_Publish(uint8_t Channel, struct Reading* Reading) {
+	PROFILER_BEGIN(PROFILER_CONVERSION);
+	Pipeline_Publish(Channel, Reading);
+	Pipeline_Trend_Step(&Trend_Table[Channel], Reading);
+	PROFILER_END(PROFILER_CONVERSION);
+	TRACE_EVENT(TRACE_CONVERSION_DONE, Channel);
+}
@@ -29,8 +29,19 @@
  ******************************************************************************
  */
 
+#ifndef __MAX31865_H
+#define __MAX31865_H
+
 #include "rtd_calculator.h"
 #include <stdbool.h>
+#include "ramfunc.h"
+#include "reading.h"
+#include "pipeline.h" //Характеристики датчика (MAX31865_PT100_R0, MAX31865_R_REF) и обработка после чтения
+
+/*--------------Подбор частоты SPI (MAX31865_SPI_Tune)------------*/
+#define MAX31865_SPI_MAX_HZ      5000000  //Максимальная частота SCK по datasheet MAX31865
+#define MAX31865_SPI_TUNE_ROUNDS 8        //Повторов набора шаблонов на каждом шаге
+/*--------------Подбор частоты SPI (MAX31865_SPI_Tune)------------*/
 
  /*----------Макросы----------*/
 #define NSS_PORT GPIOA  //Порт ножки CS
@@ -53,14 +64,36 @@
 #include "main.h"
 #endif
 
+//Результат подбора частоты SPI
+struct MAX31865_SPI_Link {
+	uint8_t Prescaler; //Выбранный BR[2:0] (fPCLK / (2 << Prescaler))
+	uint32_t Frequency; //Выбранная частота SCK, Гц
+	uint8_t Failed_prescaler; //Первый BR, на котором проверка не прошла (0xFF - все прошли)
+	uint16_t Errors; //Несовпадений на этом шаге
+};
+
+extern struct MAX31865_SPI_Link MAX31865_SPI_Link;
+
 #if defined (USE_CMSIS)
 void MAX31865_Init(SPI_TypeDef* SPI, uint8_t num_wires);
+bool MAX31865_SPI_Tune(SPI_TypeDef* SPI);
 uint8_t MAX31865_Configuration_info(SPI_TypeDef* SPI);
-double MAX31865_Get_Resistance(SPI_TypeDef* SPI);
+RAMFUNC uint16_t MAX31865_Get_Code(SPI_TypeDef* SPI);
+RAMFUNC double MAX31865_Get_Resistance(SPI_TypeDef* SPI);
+void MAX31865_Measure(SPI_TypeDef* SPI, uint8_t Channel, struct Reading* Reading);
 #elif defined (USE_HAL)
 void MAX31865_Init(SPI_HandleTypeDef * hspi, uint8_t num_wires);
 uint8_t MAX31865_Configuration_info(SPI_HandleTypeDef * hspi);
+uint16_t MAX31865_Get_Code(SPI_HandleTypeDef * hspi);
 double MAX31865_Get_Resistance(SPI_HandleTypeDef * hspi);
+void MAX31865_Measure(SPI_HandleTypeDef * hspi, uint8_t Channel, struct Reading* Reading);
 #endif
 
-double MAX31865_Get_Temperature(double Resistance);
+RAMFUNC double MAX31865_Get_Temperature(double Resistance);
+void MAX31865_Publish(uint8_t Channel, struct Reading* Reading);
+
+extern volatile uint32_t MAX31865_Sample_timestamp; //Clock_Now() в момент окончания чтения последнего измерения
+extern volatile uint8_t MAX31865_Fault_status; //Регистр Fault Status последнего измерения
+extern struct Trend_Channel Trend_Table[CHANNEL_COUNT]; //Прогноз выхода за пределы (предварительная авария) по каналам
+
+#endif /* __MAX31865_H */
@@ -0,0 +1,294 @@
+/**
+ ******************************************************************************
+ *  @file bus_sched.c
+ *  @brief Планировщик опроса каналов MAX31865 на одной шине SPI по ближайшему сроку (EDF)
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. bus_sched.h
+ ******************************************************************************
+ */
+
+#include "bus_sched.h"
+#include "clock_manager.h"
+#include <stddef.h>
+
+struct Bus_Sched_Channel Bus_Sched_Table[CHANNEL_COUNT];
+bool Bus_Sched_Overload = false;
+
+static SPI_TypeDef* Bus_Sched_SPI; //Шина всех каналов планировщика
+
+#define BUS_SCHED_CS_LOW(C)  (C)->CS->Port->BSRR = (1UL << ((C)->CS->Pin + 16))
+#define BUS_SCHED_CS_HIGH(C) (C)->CS->Port->BSRR = (1UL << (C)->CS->Pin)
+#define BUS_SCHED_BEFORE(a, b) ((int32_t) ((a) - (b)) < 0) //Момент a раньше b (с переполнением CYCCNT)
+
+/*
+ **************************************************************************************************
+ *  @breif Сброс таблицы планировщика
+ *  @param  *SPI - шина, на которой сидят все каналы
+ **************************************************************************************************
+ */
+void Bus_Sched_Init(SPI_TypeDef* SPI) {
+	Bus_Sched_SPI = SPI;
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		Bus_Sched_Table[Channel] = (struct Bus_Sched_Channel) { 0 };
+	}
+	Bus_Sched_Overload = false;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Плотность загрузки шины одним каналом
+ *  @retval Миллионные доли: стоимость операций / окно, в котором они должны уложиться
+ **************************************************************************************************
+ */
+static uint32_t Bus_Sched_Density_ppm(const struct Bus_Sched_Channel* C) {
+	uint32_t Window_ms;
+	uint32_t Cost;
+	if (C->One_shot) {
+		Window_ms = (C->Deadline_ms - BUS_SCHED_CONVERSION_MS) / 2; //Запуск - в первой половине запаса, чтение - во второй
+		Cost = C->Cost_trigger + C->Cost_read;
+	} else {
+		Window_ms = C->Deadline_ms;
+		Cost = C->Cost_read;
+	}
+	return (uint32_t) ((uint64_t) Cost * 1000000 / ((uint64_t) Window_ms * BUS_SCHED_CYCLES_PER_MS));
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Текущая загрузка шины принятыми каналами
+ *  @retval Промилле (по максимальным стоимостям операций)
+ **************************************************************************************************
+ */
+uint32_t Bus_Sched_Load_permille(void) {
+	uint32_t Load = 0;
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		if (Bus_Sched_Table[Channel].Admitted) {
+			Load += Bus_Sched_Density_ppm(&Bus_Sched_Table[Channel]);
+		}
+	}
+	return Load / 1000;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Допуск канала в планировщик
+ *  @attention Канал настраивается (режим, сброс ошибок) и пробной транзакцией измеряется стоимость
+ *  операций. Если с ним загрузка шины выше BUS_SCHED_LOAD_MAX_PERMILLE - канал не принимается.
+ *  Тактирование порта CS должно быть включено.
+ *  @param  Channel - номер канала
+ *  @param  *CS - ножка CS (должна жить все время работы)
+ *  @param  num_wires - тип подключения датчика 2, 3 или 4 проводное
+ *  @param  Period_ms - период опроса, от BUS_SCHED_AUTO_PERIOD_MS до BUS_SCHED_PERIOD_MAX_MS
+ *  @param  Deadline_ms - срок от выпуска до конца чтения, не больше периода (0 - равен периоду)
+ *  @retval true - канал принят
+ **************************************************************************************************
+ */
+bool Bus_Sched_Add(uint8_t Channel, const struct MAX31865_CS* CS, uint8_t num_wires, uint16_t Period_ms, uint16_t Deadline_ms) {
+	struct Bus_Sched_Channel* C = &Bus_Sched_Table[Channel];
+
+	if (Deadline_ms == 0) {
+		Deadline_ms = Period_ms;
+	}
+	if (Period_ms < BUS_SCHED_AUTO_PERIOD_MS || Period_ms > BUS_SCHED_PERIOD_MAX_MS || Deadline_ms > Period_ms || Deadline_ms == 0) {
+		return false;
+	}
+
+	C->Admitted = false;
+	C->CS = CS;
+	C->Period_ms = Period_ms;
+	C->Deadline_ms = Deadline_ms;
+	C->One_shot = Deadline_ms >= BUS_SCHED_ONESHOT_MIN_MS;
+	C->Config = 0x80 | 0x01 | (C->One_shot ? 0x00 : 0x40); //VBIAS вкл. постоянно, фильтр 50 Гц, авто - если срок короче 1-shot
+	if (num_wires == 3) {
+		C->Config |= 0x10;
+	}
+
+	volatile uint32_t* CR = (CS->Pin < 8) ? &CS->Port->CRL : &CS->Port->CRH;
+	uint32_t Shift = (CS->Pin % 8) * 4;
+	BUS_SCHED_CS_HIGH(C);
+	MODIFY_REG(*CR, 0xFUL << Shift, 0b0011UL << Shift); //Выход Push-Pull 50 MHz
+
+	//Пробные транзакции: запись конфигурации (как запуск 1-shot) и чтение 7 байт
+	uint8_t Write[2] = { 0x80, C->Config | 0x02 }; //Заодно сброс ошибок
+	uint8_t Address = 0x01;
+	uint8_t Rx[7];
+	uint32_t Start = Clock_Now();
+	BUS_SCHED_CS_LOW(C);
+	bool Ok = CMSIS_SPI_Data_Transmit_8BIT(Bus_Sched_SPI, Write, 2, 100);
+	BUS_SCHED_CS_HIGH(C);
+	C->Cost_trigger = Clock_Now() - Start;
+	Start = Clock_Now();
+	BUS_SCHED_CS_LOW(C);
+	Ok = Ok && CMSIS_SPI_Data_Transmit_8BIT(Bus_Sched_SPI, &Address, 1, 100) && CMSIS_SPI_Data_Receive_8BIT(Bus_Sched_SPI, Rx, 7, 100);
+	BUS_SCHED_CS_HIGH(C);
+	C->Cost_read = Clock_Now() - Start + BUS_SCHED_PUBLISH_CYCLES;
+	if (!Ok) {
+		return false;
+	}
+
+	C->Admitted = true;
+	if (Bus_Sched_Load_permille() > BUS_SCHED_LOAD_MAX_PERMILLE) {
+		C->Admitted = false;
+		return false;
+	}
+
+	C->Phase = BUS_SCHED_IDLE;
+	C->Release = Clock_Now() + (C->One_shot ? 0 : BUS_SCHED_AUTO_PERIOD_MS * BUS_SCHED_CYCLES_PER_MS); //В авто - после первого преобразования
+	C->Jobs = C->Misses = C->Skipped = C->Errors = C->Lateness_max = 0;
+	return true;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Снятие канала с опроса
+ **************************************************************************************************
+ */
+void Bus_Sched_Remove(uint8_t Channel) {
+	Bus_Sched_Table[Channel].Admitted = false;
+	Bus_Sched_Table[Channel].Phase = BUS_SCHED_IDLE;
+	Bus_Sched_Overload = Bus_Sched_Load_permille() > BUS_SCHED_LOAD_MAX_PERMILLE;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Выпуск заданий и переходы по времени для всех каналов
+ **************************************************************************************************
+ */
+static void Bus_Sched_Release(uint32_t Now) {
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		struct Bus_Sched_Channel* C = &Bus_Sched_Table[Channel];
+		if (!C->Admitted) {
+			continue;
+		}
+		if (C->Phase == BUS_SCHED_IDLE && !BUS_SCHED_BEFORE(Now, C->Release)) {
+			C->Job_deadline = C->Release + C->Deadline_ms * BUS_SCHED_CYCLES_PER_MS;
+			C->Ready = C->Release;
+			if (C->One_shot) {
+				C->Phase = BUS_SCHED_TRIGGER;
+				C->Op_deadline = C->Release + (C->Deadline_ms - BUS_SCHED_CONVERSION_MS) / 2 * BUS_SCHED_CYCLES_PER_MS;
+			} else {
+				C->Phase = BUS_SCHED_READ;
+				C->Op_deadline = C->Job_deadline;
+			}
+		} else if (C->Phase == BUS_SCHED_CONVERTING && !BUS_SCHED_BEFORE(Now, C->Ready)) {
+			C->Phase = BUS_SCHED_READ;
+			C->Op_deadline = C->Job_deadline;
+		}
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запуск 1-shot в канале
+ *  @attention При таймауте SPI преобразование не запущено - фаза не меняется
+ **************************************************************************************************
+ */
+static void Bus_Sched_Trigger(struct Bus_Sched_Channel* C) {
+	uint8_t Write[2] = { 0x80, C->Config | 0x20 }; //Бит 1-shot
+	uint32_t Start = Clock_Now();
+	BUS_SCHED_CS_LOW(C);
+	bool Ok = CMSIS_SPI_Data_Transmit_8BIT(Bus_Sched_SPI, Write, 2, BUS_SCHED_SPI_TIMEOUT_MS);
+	BUS_SCHED_CS_HIGH(C);
+	if (!Ok) {
+		C->Errors++; //Канал остается в BUS_SCHED_TRIGGER - повтор на следующем шаге
+		return;
+	}
+	C->Edge = Clock_Now(); //Преобразование стартует по фронту CS
+	if (C->Edge - Start > C->Cost_trigger) {
+		C->Cost_trigger = C->Edge - Start;
+	}
+	C->Ready = C->Edge + BUS_SCHED_CONVERSION_MS * BUS_SCHED_CYCLES_PER_MS;
+	C->Phase = BUS_SCHED_CONVERTING;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Чтение канала, публикация, учет срока и выпуск следующего задания
+ **************************************************************************************************
+ */
+static void Bus_Sched_Read(uint8_t Channel, struct Bus_Sched_Channel* C) {
+	uint8_t Address = 0x01;
+	uint8_t Rx[7];
+	uint32_t Start = Clock_Now();
+
+	BUS_SCHED_CS_LOW(C);
+	bool Ok = CMSIS_SPI_Data_Transmit_8BIT(Bus_Sched_SPI, &Address, 1, BUS_SCHED_SPI_TIMEOUT_MS) && CMSIS_SPI_Data_Receive_8BIT(Bus_Sched_SPI, Rx, 7, BUS_SCHED_SPI_TIMEOUT_MS);
+	BUS_SCHED_CS_HIGH(C);
+	if (Ok) {
+		struct Reading Reading;
+		Reading.Code = ((Rx[0] << 8) | Rx[1]) >> 1;
+		Reading.Status = Rx[6];
+		Reading.Timestamp = C->One_shot ? C->Edge : Start;
+		MAX31865_Publish(Channel, &Reading);
+		if (Reading.Status) {
+			uint8_t Write[2] = { 0x80, C->Config | 0x02 }; //Сброс ошибок (журнал уже записан)
+			BUS_SCHED_CS_LOW(C);
+			if (!CMSIS_SPI_Data_Transmit_8BIT(Bus_Sched_SPI, Write, 2, BUS_SCHED_SPI_TIMEOUT_MS)) {
+				C->Errors++;
+			}
+			BUS_SCHED_CS_HIGH(C);
+		}
+	} else {
+		C->Errors++;
+	}
+
+	uint32_t End = Clock_Now();
+	if (End - Start > C->Cost_read) {
+		C->Cost_read = End - Start;
+		Bus_Sched_Overload = Bus_Sched_Load_permille() > BUS_SCHED_LOAD_MAX_PERMILLE;
+	}
+	if (BUS_SCHED_BEFORE(C->Job_deadline, End)) {
+		C->Misses++;
+		if (End - C->Job_deadline > C->Lateness_max) {
+			C->Lateness_max = End - C->Job_deadline;
+		}
+	}
+	C->Jobs++;
+
+	//Следующий выпуск; уже прошедшие выпуски не догоняем
+	uint32_t Period = C->Period_ms * BUS_SCHED_CYCLES_PER_MS;
+	C->Release += Period;
+	while (!BUS_SCHED_BEFORE(End, C->Release + Period)) {
+		C->Release += Period;
+		C->Skipped++;
+	}
+	C->Phase = BUS_SCHED_IDLE;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Шаг планировщика: выполнить готовую операцию с самым ранним сроком
+ *  @attention Одна операция за вызов (запуск ~2 байта, чтение ~8 байт + пересчет). Не из прерываний.
+ *  @retval true - операция выполнена, false - готовых операций нет
+ **************************************************************************************************
+ */
+bool Bus_Sched_Poll(void) {
+	uint32_t Now = Clock_Now();
+	struct Bus_Sched_Channel* Next = NULL;
+	uint8_t Next_channel = 0;
+
+	Bus_Sched_Release(Now);
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		struct Bus_Sched_Channel* C = &Bus_Sched_Table[Channel];
+		if (!C->Admitted || (C->Phase != BUS_SCHED_TRIGGER && C->Phase != BUS_SCHED_READ)) {
+			continue;
+		}
+		if (Next == NULL || BUS_SCHED_BEFORE(C->Op_deadline, Next->Op_deadline)) {
+			Next = C;
+			Next_channel = Channel;
+		}
+	}
+	if (Next == NULL) {
+		return false;
+	}
+
+	if (Next->Phase == BUS_SCHED_TRIGGER) {
+		Bus_Sched_Trigger(Next);
+	} else {
+		Bus_Sched_Read(Next_channel, Next);
+	}
+	return true;
+}
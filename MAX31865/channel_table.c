@@ -0,0 +1,87 @@
+/**
+ ******************************************************************************
+ *  @file channel_table.c
+ *  @brief Таблицы состояния каналов: размер задается при компиляции, раскладка SoA
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. channel_table.h
+ ******************************************************************************
+ */
+
+#include "channel_table.h"
+#include "reading.h"
+#include "fault_log.h"
+
+struct Channel_Table Channel_Table;
+
+//ОЗУ на один канал во всех таблицах каналов
+#define CHANNEL_BYTES_PER_CHANNEL (CHANNEL_TABLE_ROW_BYTES + sizeof(struct Reading_Slot) + MAX31865_FAULT_COUNT * sizeof(uint16_t))
+
+_Static_assert(sizeof(struct Channel_Table) <= CHANNEL_COUNT * CHANNEL_TABLE_ROW_BYTES + 3, "Channel_Table: padding between arrays");
+_Static_assert(CHANNEL_COUNT <= 16, "CHANNEL_COUNT > 16: channel number is 4 bits in trace.h");
+_Static_assert(CHANNEL_COUNT * CHANNEL_BYTES_PER_CHANNEL <= CHANNEL_RAM_BUDGET, "per-channel tables exceed CHANNEL_RAM_BUDGET");
+
+/*
+ **************************************************************************************************
+ *  @breif Начальное состояние: калибровка 1.0 / 0, коды в ноль
+ **************************************************************************************************
+ */
+void Channel_Table_Init(void) {
+	for (uint32_t i = 0; i < CHANNEL_COUNT; i++) {
+		Channel_Table.Timestamp[i] = 0;
+		Channel_Table.Code[i] = 0;
+		Channel_Table.Cal_offset[i] = 0;
+		Channel_Table.Cal_gain[i] = CHANNEL_GAIN_ONE;
+		Channel_Table.Status[i] = 0;
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Перевод калибровки канала из Ом в коды АЦП
+ *  @attention Разрешение смещения - 1 код (R_ref / 32768, 0.013 Ом для 428.5 Ом),
+ *  наклона - 1/32768. Множитель ограничен диапазоном 0..2.
+ *  @param  Channel - номер канала
+ *  @param  Multiplicative - калибровка наклона
+ *  @param  Additive_ohm - калибровка смещения, Ом
+ *  @param  R_ref - референсный резистор MAX31865, Ом
+ **************************************************************************************************
+ */
+void Channel_Set_Calibration(uint8_t Channel, float Multiplicative, float Additive_ohm, double R_ref) {
+	float Gain = Multiplicative * CHANNEL_GAIN_ONE + 0.5f;
+	float Offset = (float) (Additive_ohm * 32768.0 / R_ref);
+	Channel_Table.Cal_gain[Channel] = (uint16_t) (Gain > 65535.0f ? 65535.0f : (Gain < 0.0f ? 0.0f : Gain));
+	Channel_Table.Cal_offset[Channel] = (int16_t) (Offset < 0.0f ? Offset - 0.5f : Offset + 0.5f);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Учет нового измерения канала (код, статус, время)
+ **************************************************************************************************
+ */
+void Channel_Update(uint8_t Channel, uint16_t Code, uint8_t Status, uint32_t Timestamp) {
+	Channel_Table.Code[Channel] = Code;
+	Channel_Table.Status[Channel] = Status;
+	Channel_Table.Timestamp[Channel] = Timestamp;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Код с калибровкой канала в формате Q15 (без потери дробной части)
+ **************************************************************************************************
+ */
+uint32_t Channel_Calibrated_Code_Q15(uint8_t Channel, uint16_t Code) {
+	int64_t Value = (int64_t) Code * Channel_Table.Cal_gain[Channel] + ((int64_t) Channel_Table.Cal_offset[Channel] << 15);
+	return Value < 0 ? 0 : (Value > UINT32_MAX ? UINT32_MAX : (uint32_t) Value);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif ОЗУ на один канал: эта таблица + публикация + счетчики ошибок
+ **************************************************************************************************
+ */
+uint32_t Channel_Table_Bytes_Per_Channel(void) {
+	return CHANNEL_BYTES_PER_CHANNEL;
+}
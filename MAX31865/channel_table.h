@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ *  @file channel_table.h
+ *  @brief Таблицы состояния каналов: размер задается при компиляции, раскладка SoA
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Количество каналов CHANNEL_COUNT задается один раз при компиляции (-DCHANNEL_COUNT=N),
+ *  по нему размеряются все таблицы каналов: эта, публикация (reading.h),
+ *  счетчики ошибок (fault_log.h), синхронный снимок (max31865_sync.h).
+ *
+ *  Рабочее состояние каналов хранится не массивом структур, а структурой массивов:
+ *  цикл, проходящий по всем каналам за одним полем (например, по кодам), читает
+ *  подряд лежащую память. Поля - целые минимальной ширины, массивы упорядочены по
+ *  убыванию выравнивания, поэтому внутри таблицы нет дыр на выравнивание.
+ *  Калибровка хранится в единицах кода АЦП:
+ *      Код_кал = Код * Cal_gain / CHANNEL_GAIN_ONE + Cal_offset
+ *
+ *  Бюджет ОЗУ на все таблицы каналов (CHANNEL_RAM_BUDGET) проверяется static assert
+ *  в channel_table.c. Байт на канал: Channel_Table_Bytes_Per_Channel(), команда
+ *  "mem" (telemetry.h) и отчет сборки "make -C host channel_report".
+ ******************************************************************************
+ */
+
+#ifndef __CHANNEL_TABLE_H
+#define __CHANNEL_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef CHANNEL_COUNT
+#define CHANNEL_COUNT 1 //Количество каналов (микросхем MAX31865)
+#endif
+
+#define CHANNEL_RAM_BUDGET   2048  //Байт ОЗУ на все таблицы каналов вместе
+#define CHANNEL_GAIN_ONE     32768 //Cal_gain, соответствующий множителю 1.0 (Q15)
+
+//Рабочее состояние всех каналов (структура массивов)
+struct Channel_Table {
+	uint32_t Timestamp[CHANNEL_COUNT]; //Clock_Now() последнего измерения
+	uint16_t Code[CHANNEL_COUNT]; //Последний 15-битный код АЦП
+	int16_t Cal_offset[CHANNEL_COUNT]; //Калибровка смещения, коды
+	uint16_t Cal_gain[CHANNEL_COUNT]; //Калибровка наклона, Q15 (CHANNEL_GAIN_ONE = 1.0)
+	uint8_t Status[CHANNEL_COUNT]; //Регистр Fault Status последнего измерения
+};
+
+//Байт на канал в этой таблице
+#define CHANNEL_TABLE_ROW_BYTES (sizeof(uint32_t) + 3 * sizeof(uint16_t) + sizeof(uint8_t))
+
+extern struct Channel_Table Channel_Table;
+
+void Channel_Table_Init(void); //Калибровка по умолчанию, коды в ноль
+void Channel_Set_Calibration(uint8_t Channel, float Multiplicative, float Additive_ohm, double R_ref); //Калибровка в Ом -> в коды (R = R_raw * mult + add)
+void Channel_Update(uint8_t Channel, uint16_t Code, uint8_t Status, uint32_t Timestamp); //Новое измерение канала
+uint32_t Channel_Calibrated_Code_Q15(uint8_t Channel, uint16_t Code); //Код с калибровкой, Q15 (код * 32768)
+uint32_t Channel_Table_Bytes_Per_Channel(void); //ОЗУ на один канал во всех таблицах каналов
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CHANNEL_TABLE_H */
@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ *  @file clock_manager.h
+ *  @brief Смена частоты ядра между пачками измерений: HSE 8 MHz <-> PLL 72 MHz
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  CMSIS_RCC_SystemClock_72MHz() держит ядро на 72 MHz все время, хотя большую
+ *  часть цикла оно ждет в Delay_ms(). Здесь на время ожидания ядро переводится
+ *  на HSE 8 MHz (PLL выключается), а на пересчет, регулятор и телеметрию -
+ *  обратно на PLL 72 MHz. При каждом переключении пересчитываются:
+ *  - SysTick: 1 мс (Delay_ms(), таймауты);
+ *  - USART1: BRR под ту же скорость (PCLK2 = SYSCLK);
+ *  - SPI1: на 72 MHz - делитель из MAX31865_SPI_Tune(), на 8 MHz - самый быстрый
+ *    не выше подобранной частоты;
+ *  - TIM3 (ШИМ нагревателя): PSC под тот же 1 MHz (применится со следующего периода);
+ *  - TPI->ACPR (SWO), если включен USE_TRACE.
+ *  Вся перенастройка идет при запрещенных прерываниях вместе со сменой SW, поэтому
+ *  обработчики, работающие с SPI1 (trip.c, pwm_sync.c), не застанут ни выключенный SPE,
+ *  ни делитель от другой частоты. При переходе на 72 MHz делитель SPI1 ставится до
+ *  переключения (на 8 MHz он просто медленнее), при переходе на 8 MHz - после: SCK
+ *  ни на миг не выходит за предел MAX31865 (5 MHz).
+ *  Программный SPI (soft_spi.h, TIM2 + DMA) берет такт TIM2 из RCC сам - на 8 MHz он медленнее.
+ *
+ *  DWT->CYCCNT идет от SYSCLK, поэтому все метки времени и интервалы берутся через
+ *  Clock_Now() - время в тактах 72 MHz при любой частоте: Reading.Timestamp,
+ *  синхронный снимок (max31865_sync.h), трассировка (trace.h), профилировщик
+ *  (profiler.h), задержка измерение -> ШИМ (heater_control.h), аварии (trip.h),
+ *  планировщик (bus_sched.h). Сырой DWT->CYCCNT остается только там, где нужны такты
+ *  ядра как таковые: таймауты SPI в прерываниях и бенчмарк CRC (crc32.c).
+ *  SysTick при переключении не теряет начатую мс: остаток пересчитывается в новую частоту.
+ *
+ *  Статистика (Clock_Stats): время на каждой частоте, число переключений,
+ *  худшее время переключения вверх (основное - запуск PLL) и вниз, в мкс.
+ *  Энергия - оценка по времени на частотах и типовым токам потребления из
+ *  datasheet (CLOCK_RUN_UA_*; для своей платы подставить измеренные).
+ *
+ *  Пока USE_CLOCK_SCALING не определен, Clock_Now() - это DWT->CYCCNT.
+ *
+ *      Clock_Init(); //после CMSIS_RCC_SystemClock_72MHz() и настройки периферии
+ *      ...
+ *      Clock_Set(CLOCK_HSE_8MHZ); Delay_ms(200); Clock_Set(CLOCK_PLL_72MHZ);
+ ******************************************************************************
+ */
+
+#ifndef __CLOCK_MANAGER_H
+#define __CLOCK_MANAGER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f103xx_CMSIS.h"
+
+/*----------Включение смены частоты----------*/
+//#define USE_CLOCK_SCALING   //Раскомментировать, чтобы ожидание в основном цикле шло на 8 MHz
+/*----------Включение смены частоты----------*/
+
+#define CLOCK_HSE_HZ   8000000  //Кварц HSE
+#define CLOCK_PLL_HZ   72000000 //HSE * 9
+#define CLOCK_NOW_PER_US (CLOCK_PLL_HZ / 1000000) //Тактов Clock_Now() в мкс (при любой частоте ядра)
+#define CLOCK_USART1_BAUD 9600  //Скорость USART1, как в CMSIS_USART1_Init()
+#define CLOCK_TIM3_HZ  1000000  //Такт TIM3 (HEATER_PWM_PRESCALER на 72 MHz)
+#define CLOCK_SYSTICK_REMAINING_MIN 16 //Наименьший остаток мс SysTick при переключении, такты (успеть сменить LOAD)
+#define CLOCK_SPI_BSY_CYCLES 1440 //Предел ожидания BSY SPI1 перед сменой делителя, такты ядра (прерывания запрещены)
+#define CLOCK_RUN_UA_8MHZ  5500 //Типовой ток в Run на 8 MHz, все периферия вкл., мкА (datasheet STM32F103x8)
+#define CLOCK_RUN_UA_72MHZ 36000 //Типовой ток в Run на 72 MHz, мкА
+#define CLOCK_SUPPLY_MV 3300 //Напряжение питания, мВ
+
+//Частоты ядра
+enum {
+	CLOCK_HSE_8MHZ, //HSE напрямую, PLL выключен
+	CLOCK_PLL_72MHZ, //PLL от HSE
+	CLOCK_MODES
+};
+
+//Статистика переключений
+struct Clock_Stats {
+	uint8_t Mode; //Текущая частота
+	uint32_t Time_ms[CLOCK_MODES]; //Время на каждой частоте, мс
+	uint32_t Switches; //Число переключений
+	uint32_t Up_us_max; //Худшее переключение 8 -> 72 MHz, мкс
+	uint32_t Down_us_max; //Худшее переключение 72 -> 8 MHz, мкс
+};
+
+extern struct Clock_Stats Clock_Stats;
+
+#if defined (USE_CLOCK_SCALING)
+
+extern volatile uint32_t Clock_Base; //Clock_Now() в момент последнего переключения
+extern volatile uint32_t Clock_Mark; //DWT->CYCCNT в момент последнего переключения
+extern volatile uint32_t Clock_Mult; //Тактов 72 MHz на такт текущей частоты (1 или 9)
+
+/*
+ **************************************************************************************************
+ *  @breif Время в тактах 72 MHz, непрерывное через переключения частоты
+ *  @attention Переключение идет только из основного цикла с запретом прерываний, поэтому
+ *  из основного цикла и из прерываний тройка Base/Mark/Mult читается согласованной.
+ **************************************************************************************************
+ */
+static inline uint32_t Clock_Now(void) {
+	return Clock_Base + (DWT->CYCCNT - Clock_Mark) * Clock_Mult;
+}
+
+void Clock_Init(void); //Начало учета (ядро уже на 72 MHz)
+void Clock_Set(uint8_t Mode); //Переключение частоты с пересчетом периферии
+uint32_t Clock_Energy_uJ(void); //Оценка энергии с Clock_Init(), мкДж
+
+#else
+
+#define Clock_Now() DWT->CYCCNT
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CLOCK_MANAGER_H */
@@ -0,0 +1,81 @@
+/**
+ ******************************************************************************
+ *  @file delta_t.c
+ *  @brief Разность температур пары датчиков в кодах АЦП с общей калибровкой
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. delta_t.h
+ ******************************************************************************
+ */
+
+#include "delta_t.h"
+
+#define DELTA_T_SLOPE_STEP 0.5 //Шаг для расчета наклона (центральная разность), °C
+
+/*
+ **************************************************************************************************
+ *  @breif Начальное состояние пары
+ **************************************************************************************************
+ */
+void Delta_T_Init(struct Delta_T_Pair* Pair, uint8_t Channel_a, uint8_t Channel_b) {
+	Pair->Channel_a = Channel_a;
+	Pair->Channel_b = Channel_b;
+	Pair->Filter = 0;
+	Pair->Mean_code = -1;
+	Pair->mK_per_code_Q16 = 0;
+	Pair->Delta_raw_mK = 0;
+	Pair->Delta_mK = 0;
+	Pair->Skew_cycles = 0;
+	Pair->Count = 0;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Пересчет наклона мК/код в средней точке пары (double, редко)
+ **************************************************************************************************
+ */
+static void Delta_T_Slope(struct Delta_T_Pair* Pair, int32_t Mean_code) {
+	Pair->mK_per_code_Q16 = Pipeline_mK_per_code_Q16(Mean_code, DELTA_T_SLOPE_STEP);
+	Pair->Mean_code = Mean_code;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Обработка синхронного снимка
+ *  @param  *Pair - пара
+ *  @param  *Snapshot - снимок после MAX31865_Sync_Collect()
+ *  @retval true - разность обновлена
+ **************************************************************************************************
+ */
+bool Delta_T_Update(struct Delta_T_Pair* Pair, const struct MAX31865_Snapshot* Snapshot) {
+	uint8_t a = Pair->Channel_a;
+	uint8_t b = Pair->Channel_b;
+
+	if (!Snapshot->Valid || Snapshot->Status[a] || Snapshot->Status[b]) {
+		return false;
+	}
+
+	uint32_t Cal_a = Channel_Calibrated_Code_Q15(a, Snapshot->Code[a]); //Каждый канал - со своей калибровкой
+	uint32_t Cal_b = Channel_Calibrated_Code_Q15(b, Snapshot->Code[b]);
+	int32_t Mean_code = (int32_t) (((uint64_t) Cal_a + Cal_b) >> 16); //Средний калиброванный код
+	int32_t Delta_Q8 = Pipeline_Delta_code_Q8(a, Snapshot->Code[a], b, Snapshot->Code[b]);
+
+	if (Pair->Mean_code < 0 || Mean_code - Pair->Mean_code > DELTA_T_SLOPE_REFRESH || Pair->Mean_code - Mean_code > DELTA_T_SLOPE_REFRESH) {
+		Delta_T_Slope(Pair, Mean_code);
+	}
+
+	int32_t Step = Delta_Q8 - Pair->Filter;
+	if (Pair->Count == 0 || Step > DELTA_T_STEP_CODES * 256 || Step < -DELTA_T_STEP_CODES * 256) {
+		Pair->Filter = Delta_Q8; //Реальный перепад - не размазываем
+	} else {
+		Pair->Filter += Step >> DELTA_T_FILTER_SHIFT;
+	}
+
+	Pair->Delta_raw_mK = (int32_t) (((int64_t) Delta_Q8 * Pair->mK_per_code_Q16) >> 24);
+	Pair->Delta_mK = (int32_t) (((int64_t) Pair->Filter * Pair->mK_per_code_Q16) >> 24);
+	Pair->Skew_cycles = Snapshot->Trigger_offset[b] > Snapshot->Trigger_offset[a] ? Snapshot->Trigger_offset[b] - Snapshot->Trigger_offset[a] : Snapshot->Trigger_offset[a] - Snapshot->Trigger_offset[b];
+	Pair->Count++;
+	return true;
+}
@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ *  @file fault_log.c
+ *  @brief Расшифровка ошибок MAX31865, счетчики по битам и журнал событий в ОЗУ
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. fault_log.h
+ ******************************************************************************
+ */
+
+#include "fault_log.h"
+
+extern volatile uint32_t SysTimer_ms; //Время от запуска, мс (см. stm32f103xx_CMSIS.c)
+
+struct Fault_Log Fault_Log;
+
+//Имена битов (порядок как в enum MAX31865_Fault)
+static const char* const Fault_Log_Names[MAX31865_FAULT_COUNT] = {
+	"rtd_high",
+	"rtd_low",
+	"refin_high",
+	"refin_low",
+	"rtdin_low",
+	"ovuv"
+};
+
+/*
+ **************************************************************************************************
+ *  @breif Учет ошибки канала
+ *  @param  Channel - номер канала
+ *  @param  Status - регистр Fault Status (нулевой игнорируется)
+ **************************************************************************************************
+ */
+void Fault_Log_Record(uint8_t Channel, uint8_t Status) {
+	if (Status == 0 || Channel >= CHANNEL_COUNT) {
+		return;
+	}
+	for (uint32_t i = 0; i < MAX31865_FAULT_COUNT; i++) {
+		if ((Status & MAX31865_FAULT_MASK(i)) && Fault_Log.Counters[i][Channel] != UINT16_MAX) {
+			Fault_Log.Counters[i][Channel]++;
+		}
+	}
+	struct Fault_Event* Event = &Fault_Log.Events[Fault_Log.Total % FAULT_LOG_SIZE];
+	Event->Time_ms = SysTimer_ms;
+	Event->Channel = Channel;
+	Event->Status = Status;
+	Fault_Log.Total++;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Очистка журнала и счетчиков
+ **************************************************************************************************
+ */
+void Fault_Log_Reset(void) {
+	for (uint32_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		for (uint32_t i = 0; i < MAX31865_FAULT_COUNT; i++) {
+			Fault_Log.Counters[i][Channel] = 0;
+		}
+	}
+	Fault_Log.Total = 0;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Короткое имя бита ошибки
+ **************************************************************************************************
+ */
+const char* Fault_Log_Name(enum MAX31865_Fault Fault) {
+	return Fault < MAX31865_FAULT_COUNT ? Fault_Log_Names[Fault] : "?";
+}
@@ -0,0 +1,204 @@
+/**
+ ******************************************************************************
+ *  @file heater_control.c
+ *  @brief Управление нагревателем: ПИД-регулятор по MAX31865 + ШИМ TIM3
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание подключения и измерения задержки см. heater_control.h
+ ******************************************************************************
+ */
+
+#include "heater_control.h"
+#include "profiler.h"
+#include "trace.h"
+#include "clock_manager.h"
+
+extern volatile uint32_t SysTimer_ms; //Время от запуска, мс (см. stm32f103xx_CMSIS.c)
+
+struct PID_Controller Heater_PID; //Регулятор нагревателя
+struct PID_Autotune Heater_Autotune; //Автонастройка регулятора нагревателя
+struct PID_Code_Space Heater_Code_Space = { .Channel = 0 }; //Пересчет уставки и коэффициентов в коды АЦП (калибровка канала 0)
+volatile uint32_t Heater_Latency_cycles = 0; //Задержка измерение -> ШИМ на последнем шаге, такты
+volatile uint32_t Heater_Latency_max_cycles = 0; //Максимальная задержка измерение -> ШИМ, такты
+volatile bool Heater_Sensor_fault = false; //Нагреватель выключен по ошибке датчика
+static bool Heater_Resume_automatic = false; //Регулятор был в автомате до ошибки датчика
+
+/*
+ **************************************************************************************************
+ *  @breif Учет задержки измерение -> ШИМ (вызывается сразу после записи TIM3->CCR1)
+ *  @param  Timestamp - Reading.Timestamp выборки, по которой сделан шаг
+ **************************************************************************************************
+ */
+static inline void Heater_Control_Latency_Update(uint32_t Timestamp) {
+	TRACE_EVENT(TRACE_ACTUATION, 0);
+	uint32_t Latency = Clock_Now() - Timestamp;
+	Heater_Latency_cycles = Latency;
+	if (Latency > Heater_Latency_max_cycles) {
+		Heater_Latency_max_cycles = Latency;
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Настройка ШИМ нагревателя и регулятора
+ *  @attention TIM3 CH1 выводится на PB4 (partial remap), т.к. PA6 занята SPI1 MISO.
+ *  Регулятор стартует в ручном режиме с нулевым выходом, коэффициенты и уставка - по умолчанию
+ *  (Pipeline_Heater_Init(), pipeline.h). Переход в автомат - PID_Set_Automatic() по первому измерению.
+ **************************************************************************************************
+ */
+void Heater_Control_init(void) {
+	CMSIS_DWT_Cycle_Counter_init(); //Счетчик тактов для измерения задержки
+
+	SET_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM3EN); //Запуск тактирования таймера 3
+	SET_BIT(RCC->APB2ENR, RCC_APB2ENR_AFIOEN); //Запуск тактирования альтернативных функций
+	SET_BIT(RCC->APB2ENR, RCC_APB2ENR_IOPBEN); //Запуск тактирования порта B
+
+	//Partial remap TIM3: CH1 -> PB4, CH2 -> PB5 (см. п. 9.3.7 Timer alternate function remapping)
+	//Биты SWJ_CFG только на запись, поэтому при изменении MAPR повторно записываем Serial wire (как в CMSIS_Debug_init)
+	MODIFY_REG(AFIO->MAPR, AFIO_MAPR_SWJ_CFG | AFIO_MAPR_TIM3_REMAP, (0b010 << AFIO_MAPR_SWJ_CFG_Pos) | AFIO_MAPR_TIM3_REMAP_PARTIALREMAP);
+
+	/*Настройка ножки PB4 под ШИМ*/
+	MODIFY_REG(GPIOB->CRL, GPIO_CRL_CNF4_Msk, 0b10 << GPIO_CRL_CNF4_Pos); //Alternate Function output Push-pull
+	MODIFY_REG(GPIOB->CRL, GPIO_CRL_MODE4_Msk, 0b11 << GPIO_CRL_MODE4_Pos); //Maximum output speed 50 MHz
+
+	/*Настройка таймера 3*/
+	CLEAR_BIT(TIM3->CR1, TIM_CR1_CEN); //Остановим таймер на время настройки
+	CLEAR_BIT(TIM3->CR1, TIM_CR1_DIR); //Считаем вверх
+	MODIFY_REG(TIM3->CR1, TIM_CR1_CMS_Msk, 0b00 << TIM_CR1_CMS_Pos); //Выравнивание по краю
+	SET_BIT(TIM3->CR1, TIM_CR1_ARPE); //Auto-reload preload enable
+	TIM3->PSC = HEATER_PWM_PRESCALER - 1;
+	TIM3->ARR = HEATER_PWM_PERIOD - 1;
+
+	/*Настройка шим(Канал 1)*/
+	MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_CC1S_Msk, 0b00 << TIM_CCMR1_CC1S_Pos); //CC1 channel is configured as output
+	CLEAR_BIT(TIM3->CCMR1, TIM_CCMR1_OC1FE); //Fast mode disable
+	SET_BIT(TIM3->CCMR1, TIM_CCMR1_OC1PE); //Preload enable (новое значение CCR1 - с начала следующего периода)
+	MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_OC1M_Msk, 0b110 << TIM_CCMR1_OC1M_Pos); //PWM MODE 1
+	TIM3->CCR1 = 0; //Нагреватель выключен
+	CLEAR_BIT(TIM3->CCER, TIM_CCER_CC1P); //OC1 active high
+	SET_BIT(TIM3->CCER, TIM_CCER_CC1E); //OC1 signal is output on the corresponding output pin
+
+	SET_BIT(TIM3->EGR, TIM_EGR_UG); //Загрузим PSC, ARR и CCR1 из буферов
+	SET_BIT(TIM3->CR1, TIM_CR1_CEN); //Запуск таймера
+
+	Pipeline_Heater_Init(&Heater_PID, HEATER_PID_SETPOINT);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Ошибка датчика: нагреватель выключен, пока она не снимется
+ *  @attention Обрыв или замыкание RTD дает код у края шкалы - регулятор увидел бы ложную
+ *  температуру и мог бы включить полную мощность. Пока Status != 0, регулятор в ручном
+ *  режиме с нулевым выходом и CCR1 = 0, автонастройка прерывается (FAILED). На первой
+ *  выборке без ошибки регулятор безударно возвращается в автомат, если был в нем до ошибки.
+ *  @param  *Reading - новое измерение
+ *  @param  Measurement - вход регулятора по этому измерению (0.01 °C или код АЦП)
+ *  @retval true - ошибка датчика, шаг регулятора пропускается
+ **************************************************************************************************
+ */
+static bool Heater_Control_Sensor_Fault(const struct Reading* Reading, int32_t Measurement) {
+	if (Reading->Status != 0) {
+		if (!Heater_Sensor_fault) {
+			Heater_Resume_automatic = Heater_PID.Automatic;
+			Heater_Sensor_fault = true;
+		}
+		if (Heater_Autotune.State == PID_AUTOTUNE_RELAY) {
+			Heater_Autotune.State = PID_AUTOTUNE_FAILED;
+		}
+		PID_Set_Manual(&Heater_PID, 0);
+		TIM3->CCR1 = 0;
+		return true;
+	}
+	if (Heater_Sensor_fault) {
+		Heater_Sensor_fault = false;
+		if (Heater_Resume_automatic) {
+			PID_Set_Automatic(&Heater_PID, Measurement);
+		}
+	}
+	return false;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Шаг регулятора нагревателя
+ *  @attention Вызывать только по новому измерению MAX31865 (не по старому повторно).
+ *  @param  *Reading - новое измерение: Temperature, Status, Timestamp
+ **************************************************************************************************
+ */
+void Heater_Control_Update(const struct Reading* Reading) {
+	PROFILER_BEGIN(PROFILER_HEATER_UPDATE);
+	int32_t Measurement = Pipeline_Centi_degC(Reading->Temperature); //°C -> 0.01 °C
+	if (!Heater_Control_Sensor_Fault(Reading, Measurement)) { //При ошибке датчика нагреватель выключен
+		if (Heater_Autotune.State == PID_AUTOTUNE_RELAY) {
+			TIM3->CCR1 = (uint16_t) PID_Autotune_Step(&Heater_Autotune, Measurement, SysTimer_ms);
+			if (Heater_Autotune.State == PID_AUTOTUNE_DONE) {
+				PID_Autotune_Apply(&Heater_Autotune, &Heater_PID, Measurement);
+			} else if (Heater_Autotune.State == PID_AUTOTUNE_FAILED) {
+				PID_Set_Manual(&Heater_PID, 0);
+				TIM3->CCR1 = 0;
+			}
+		} else {
+			TIM3->CCR1 = (uint16_t) PID_Compute(&Heater_PID, Measurement);
+		}
+	}
+	PROFILER_END(PROFILER_HEATER_UPDATE);
+
+	Heater_Control_Latency_Update(Reading->Timestamp);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Уставка для режима работы в кодах АЦП
+ *  @attention Коэффициенты берутся из Heater_Code_Space.Kp/Ki/Kd (в тактах ШИМ на 0.01 °C).
+ *  Калибровка - канала 0 из Channel_Table (Channel_Set_Calibration()), та же, что у измерения.
+ *  Линеаризация выполняется только если уставка изменилась. После смены коэффициентов
+ *  или калибровки вызовите PID_Code_Space_Linearise(&Heater_Code_Space, &Heater_PID).
+ *  @param  Setpoint - уставка, °C
+ **************************************************************************************************
+ */
+void Heater_Control_Code_Setpoint(float Setpoint) {
+	PID_Code_Space_Set_Setpoint(&Heater_Code_Space, &Heater_PID, Setpoint);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Шаг регулятора нагревателя в кодах АЦП
+ *  @attention Вызывать только по новому измерению (Code, Status, Timestamp уже заполнены,
+ *  пересчет в температуру не нужен). Только целочисленная арифметика.
+ *  @param  *Reading - новое измерение: Code - 15-битный код АЦП MAX31865, Status, Timestamp
+ **************************************************************************************************
+ */
+void Heater_Control_Update_Code(const struct Reading* Reading) {
+	PROFILER_BEGIN(PROFILER_HEATER_UPDATE);
+	if (!Heater_Control_Sensor_Fault(Reading, Reading->Code)) {
+		TIM3->CCR1 = (uint16_t) PID_Compute(&Heater_PID, Reading->Code);
+	}
+	PROFILER_END(PROFILER_HEATER_UPDATE);
+	Heater_Control_Latency_Update(Reading->Timestamp);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запуск релейной автонастройки регулятора нагревателя
+ *  @attention Реле качает мощность 50% +- Output_step вокруг уставки.
+ *  Регулятор на время автонастройки переводится в ручной режим.
+ *  @param  Setpoint - уставка, 0.01 °C
+ *  @param  Hysteresis - гистерезис реле (больше шума измерения), 0.01 °C
+ *  @param  Output_step - амплитуда реле, такты ШИМ (не более HEATER_PWM_PERIOD / 2)
+ *  @param  Sample_period_ms - период вызова Heater_Control_Update(), мс
+ **************************************************************************************************
+ */
+void Heater_Control_Autotune_Start(int32_t Setpoint, int32_t Hysteresis, int32_t Output_step, uint32_t Sample_period_ms) {
+	PID_Set_Manual(&Heater_PID, HEATER_PWM_PERIOD / 2);
+	Heater_PID.Setpoint = Setpoint;
+	Heater_Autotune.Setpoint = Setpoint;
+	Heater_Autotune.Hysteresis = Hysteresis;
+	Heater_Autotune.Output_bias = HEATER_PWM_PERIOD / 2;
+	Heater_Autotune.Output_step = Output_step;
+	Heater_Autotune.Sample_period_ms = Sample_period_ms;
+	Heater_Autotune.Timeout_ms = 2UL * 60UL * 60UL * 1000UL; //2 часа
+	Heater_Autotune.Rule = PID_AUTOTUNE_TYREUS_LUYBEN;
+	PID_Autotune_Start(&Heater_Autotune, SysTimer_ms);
+}
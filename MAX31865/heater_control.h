@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ *  @file heater_control.h
+ *  @brief Управление нагревателем: ПИД-регулятор по MAX31865 + ШИМ TIM3
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  ШИМ нагревателя: TIM3 CH1. PA6 занята под SPI1 MISO (MAX31865), поэтому
+ *  TIM3 переводится в partial remap: CH1 -> PB4 (NJTRST свободна в режиме Serial wire,
+ *  см. CMSIS_Debug_init()).
+ *
+ *  Регулятор вызывается только по новому измерению MAX31865, старое повторно не подается:
+ *      MAX31865_Measure(SPI1, 0, &Reading);
+ *      Heater_Control_Update(&Reading);
+ *  С USE_TRIP выборки копятся в кольце DRDY, и шаг делается раз за проход цикла по самой
+ *  новой из них (main.c); если выборок не было - шага нет.
+ *
+ *  Ошибка датчика (Reading.Status != 0): нагреватель выключается (регулятор в ручном режиме
+ *  с нулевым выходом, CCR1 = 0) и остается выключенным, пока ошибка не снимется;
+ *  Heater_Sensor_fault = true. Затем регулятор безударно возвращается в автомат, если был в нем.
+ *
+ *  Задержка "измерение -> ШИМ" измеряется на каждом шаге через Clock_Now() (clock_manager.h):
+ *  от Reading.Timestamp выборки (окончание чтения регистров; с USE_PWM_SYNC - фронт запуска
+ *  1-shot, т.е. вместе с преобразованием) до записи TIM3->CCR1. Для измерения из
+ *  MAX31865_Measure() в нее входит пересчет сопротивления в температуру (double, программная
+ *  эмуляция на M3) и сам шаг PID_Compute() (только целочисленная арифметика); с USE_TRIP -
+ *  еще и ожидание выборки в кольце до прохода цикла (до Delay_ms() основного цикла).
+ *  Последнее и максимальное значения в тактах: Heater_Latency_cycles, Heater_Latency_max_cycles
+ *  (команда "heater", telemetry.h). Перевод в мкс: cycles / CLOCK_NOW_PER_US (такты 72 MHz
+ *  и при смене частоты). Значения на плате в этом описании не приведены - их нужно снять
+ *  командой "heater" на железе. Новое значение CCR1 применяется с начала следующего периода
+ *  ШИМ (preload включен).
+ *
+ *  Автонастройка (pid_autotune.h): Heater_Control_Autotune_Start() переключает выход на реле.
+ *  Heater_Control_Update() продолжает вызываться как обычно; по окончании коэффициенты
+ *  переносятся в Heater_PID и регулятор безударно переходит в автомат. При неудаче
+ *  нагреватель выключается и регулятор остается в ручном режиме.
+ *
+ *  Режим работы в кодах АЦП (pid_code_space.h): уставка и коэффициенты задаются в
+ *  Heater_Code_Space (в °C), Heater_Control_Code_Setpoint() пересчитывает их в коды
+ *  с калибровкой канала 0 из Channel_Table (Channel_Set_Calibration(), как в main.c),
+ *  а в цикле по новому измерению вызывается Heater_Control_Update_Code(&Reading) (нужны
+ *  только Code, Status, Timestamp) - без double на каждом шаге, можно крутить контур с
+ *  частотой преобразования MAX31865.
+ ******************************************************************************
+ */
+
+#ifndef __HEATER_CONTROL_H
+#define __HEATER_CONTROL_H
+
+#include "MAX31865.h"
+#include "pid_controller.h"
+#include "pid_autotune.h"
+#include "pid_code_space.h"
+
+/*----------Настройки ШИМ нагревателя----------*/
+#define HEATER_PWM_PRESCALER 72   //Делитель TIM3: 72MHz / 72 = 1MHz (1 такт ШИМ = 1 мкс)
+//HEATER_PWM_PERIOD и настройки регулятора по умолчанию (HEATER_PID_*) - в pipeline.h, общие с host/replay.c
+/*----------Настройки ШИМ нагревателя----------*/
+
+extern struct PID_Controller Heater_PID; //Регулятор нагревателя
+extern struct PID_Autotune Heater_Autotune; //Автонастройка регулятора нагревателя
+extern struct PID_Code_Space Heater_Code_Space; //Пересчет уставки и коэффициентов в коды АЦП
+extern volatile uint32_t Heater_Latency_cycles; //Задержка измерение -> ШИМ на последнем шаге, такты
+extern volatile uint32_t Heater_Latency_max_cycles; //Максимальная задержка измерение -> ШИМ, такты
+extern volatile bool Heater_Sensor_fault; //Нагреватель выключен по ошибке датчика
+
+void Heater_Control_init(void); //Настройка TIM3 CH1 (PB4) под ШИМ нагревателя, DWT и регулятора
+void Heater_Control_Update(const struct Reading* Reading); //Шаг регулятора по новому измерению и запись TIM3->CCR1 (при ошибке датчика - 0)
+void Heater_Control_Code_Setpoint(float Setpoint); //Уставка (°C) для режима работы в кодах АЦП
+void Heater_Control_Update_Code(const struct Reading* Reading); //Шаг регулятора по коду АЦП нового измерения и запись TIM3->CCR1 (при ошибке датчика - 0)
+void Heater_Control_Autotune_Start(int32_t Setpoint, int32_t Hysteresis, int32_t Output_step, uint32_t Sample_period_ms); //Запуск релейной автонастройки
+
+#endif /* __HEATER_CONTROL_H */
@@ -0,0 +1,431 @@
+/**
+ ******************************************************************************
+ *  @file i2c_dma.c
+ *  @brief Неблокирующий I2C1: очередь запросов, автомат на прерываниях EV/ER и DMA
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. i2c_dma.h. Файл пустой, пока не определен USE_I2C_DMA.
+ ******************************************************************************
+ */
+
+#include "i2c_dma.h"
+#include <stddef.h>
+
+#if defined (USE_I2C_DMA)
+
+extern volatile uint32_t SysTimer_ms; //Время от запуска, мс (см. stm32f103xx_CMSIS.c)
+
+struct I2C_DMA_Stats I2C_DMA_Stats;
+
+//Этапы автомата
+enum {
+	I2C_DMA_PHASE_IDLE, //Шина свободна
+	I2C_DMA_PHASE_START, //Ждем SB, дальше адрес на запись (или на чтение без адреса памяти)
+	I2C_DMA_PHASE_ADDRESS, //Ждем ADDR после адреса на запись
+	I2C_DMA_PHASE_MEM_ADDRESS, //Байты адреса памяти по TXE
+	I2C_DMA_PHASE_WRITE_DATA, //Данные через DMA1 Channel6
+	I2C_DMA_PHASE_WRITE_END, //Ждем BTF последнего байта, дальше STOP
+	I2C_DMA_PHASE_RESTART, //Ждем BTF адреса памяти, дальше повторный START
+	I2C_DMA_PHASE_READ_START, //Ждем SB повторного START, дальше адрес на чтение
+	I2C_DMA_PHASE_READ_ADDRESS, //Ждем ADDR после адреса на чтение
+	I2C_DMA_PHASE_READ_ONE, //N = 1: ждем RXNE
+	I2C_DMA_PHASE_READ_TWO, //N = 2: ждем BTF (оба байта в DR и сдвиговом регистре)
+	I2C_DMA_PHASE_READ_DATA //N >= 3: данные через DMA1 Channel7
+};
+
+static struct I2C_DMA_Request* volatile I2C_DMA_Queue[I2C_DMA_QUEUE_SIZE];
+static volatile uint32_t I2C_DMA_Head = 0; //Двигает только I2C_DMA_Submit()
+static volatile uint32_t I2C_DMA_Tail = 0; //Двигают только прерывания (и I2C_DMA_Poll() при запрещенных прерываниях)
+
+static struct I2C_DMA_Request* volatile I2C_DMA_Current = NULL; //Запрос на шине
+static volatile uint8_t I2C_DMA_Phase = I2C_DMA_PHASE_IDLE;
+static volatile uint32_t I2C_DMA_Start_ms; //SysTimer_ms при запуске текущего запроса
+static uint8_t I2C_DMA_Mem_index; //Сколько байт адреса памяти уже отдано
+
+static void I2C_DMA_Next(void);
+
+/*
+ **************************************************************************************************
+ *  @breif Настройка I2C1 под прерывания и DMA (после CMSIS_I2C1_Init() или сброса блока)
+ **************************************************************************************************
+ */
+static void I2C_DMA_Peripheral_init(void) {
+	CMSIS_I2C1_Init();
+	SET_BIT(I2C1->CR2, I2C_CR2_ITEVTEN | I2C_CR2_ITERREN); //События и ошибки - в прерывания
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Завершение текущего запроса и запуск следующего
+ *  @attention Только из обработчиков I2C_DMA (или при запрещенных прерываниях).
+ *  @param  Status - I2C_DMA_DONE ... I2C_DMA_TIMEOUT
+ **************************************************************************************************
+ */
+static void I2C_DMA_Finish(uint8_t Status) {
+	CLEAR_BIT(DMA1_Channel6->CCR, DMA_CCR_EN);
+	CLEAR_BIT(DMA1_Channel7->CCR, DMA_CCR_EN);
+	WRITE_REG(DMA1->IFCR, DMA_IFCR_CGIF6 | DMA_IFCR_CGIF7);
+	CLEAR_BIT(I2C1->CR2, I2C_CR2_DMAEN | I2C_CR2_LAST | I2C_CR2_ITBUFEN);
+	CLEAR_BIT(I2C1->CR1, I2C_CR1_POS | I2C_CR1_ACK);
+
+	switch (Status) {
+	case I2C_DMA_DONE:
+		I2C_DMA_Stats.Done++;
+		break;
+	case I2C_DMA_NACK:
+		I2C_DMA_Stats.Nacks++;
+		break;
+	case I2C_DMA_TIMEOUT:
+		I2C_DMA_Stats.Timeouts++;
+		break;
+	default:
+		I2C_DMA_Stats.Errors++;
+		break;
+	}
+
+	struct I2C_DMA_Request* Request = I2C_DMA_Current;
+	I2C_DMA_Current = NULL;
+	I2C_DMA_Phase = I2C_DMA_PHASE_IDLE;
+	if (Request) {
+		Request->Status = Status;
+		if (Request->Callback) {
+			Request->Callback(Request);
+		}
+	}
+	I2C_DMA_Next();
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запуск следующего запроса из очереди, если шина свободна
+ **************************************************************************************************
+ */
+static void I2C_DMA_Next(void) {
+	if (I2C_DMA_Current || I2C_DMA_Tail == I2C_DMA_Head) {
+		return;
+	}
+	__DMB(); //Запрос записан раньше, чем сдвинут Head
+	struct I2C_DMA_Request* Request = I2C_DMA_Queue[I2C_DMA_Tail & (I2C_DMA_QUEUE_SIZE - 1)];
+	I2C_DMA_Tail++;
+	I2C_DMA_Current = Request;
+	I2C_DMA_Start_ms = SysTimer_ms;
+
+	//STOP прошлого запроса выставляется на шину не сразу: START до этого не давать
+	for (uint32_t i = 0; READ_BIT(I2C1->CR1, I2C_CR1_STOP) && i < I2C_DMA_STOP_SPIN; i++) ;
+
+	if (READ_BIT(I2C1->SR2, I2C_SR2_BUSY)) {
+		if ((READ_BIT(GPIOB->IDR, GPIO_IDR_IDR6)) && (READ_BIT(GPIOB->IDR, GPIO_IDR_IDR7))) {
+			//Линия на самом деле свободна, а BUSY висит - как в CMSIS_I2C_MemRead()
+			I2C_DMA_Peripheral_init();
+		} else {
+			I2C_DMA_Finish(I2C_DMA_ERROR); //Шину держит кто-то другой
+			return;
+		}
+	}
+
+	I2C_DMA_Phase = I2C_DMA_PHASE_START;
+	SET_BIT(I2C1->CR1, I2C_CR1_START);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Подготовка приема до START на чтение (ACK/POS/LAST/DMA по числу байт)
+ **************************************************************************************************
+ */
+static void I2C_DMA_Read_Setup(void) {
+	struct I2C_DMA_Request* Request = I2C_DMA_Current;
+	if (Request->Size_data == 1) {
+		CLEAR_BIT(I2C1->CR1, I2C_CR1_POS | I2C_CR1_ACK); //NACK ставится до сброса ADDR
+	} else if (Request->Size_data == 2) {
+		SET_BIT(I2C1->CR1, I2C_CR1_POS | I2C_CR1_ACK); //ACK относится к следующему байту
+	} else {
+		CLEAR_BIT(I2C1->CR1, I2C_CR1_POS);
+		SET_BIT(I2C1->CR1, I2C_CR1_ACK);
+		DMA1_Channel7->CCR = 0;
+		DMA1_Channel7->CPAR = (uint32_t) &I2C1->DR;
+		DMA1_Channel7->CMAR = (uint32_t) Request->data;
+		DMA1_Channel7->CNDTR = Request->Size_data;
+		DMA1_Channel7->CCR = DMA_CCR_MINC | DMA_CCR_TCIE | DMA_CCR_TEIE | (0b10 << DMA_CCR_PL_Pos);
+		SET_BIT(DMA1_Channel7->CCR, DMA_CCR_EN);
+		SET_BIT(I2C1->CR2, I2C_CR2_DMAEN | I2C_CR2_LAST); //NACK на последнем байте DMA ставит блок
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запуск передачи данных через DMA (без данных - сразу ожидание BTF и STOP)
+ **************************************************************************************************
+ */
+static void I2C_DMA_Write_Data(void) {
+	struct I2C_DMA_Request* Request = I2C_DMA_Current;
+	CLEAR_BIT(I2C1->CR2, I2C_CR2_ITBUFEN);
+	if (Request->Size_data == 0) {
+		I2C_DMA_Phase = I2C_DMA_PHASE_WRITE_END; //Ждем BTF последнего байта адреса памяти
+		return;
+	}
+	DMA1_Channel6->CCR = 0;
+	DMA1_Channel6->CPAR = (uint32_t) &I2C1->DR;
+	DMA1_Channel6->CMAR = (uint32_t) Request->data;
+	DMA1_Channel6->CNDTR = Request->Size_data;
+	DMA1_Channel6->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_TCIE | DMA_CCR_TEIE | (0b10 << DMA_CCR_PL_Pos);
+	I2C_DMA_Phase = I2C_DMA_PHASE_WRITE_DATA;
+	SET_BIT(DMA1_Channel6->CCR, DMA_CCR_EN);
+	SET_BIT(I2C1->CR2, I2C_CR2_DMAEN); //TXE уже стоит - DMA сразу кладет первый байт
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Инициализация I2C1, DMA и прерываний
+ **************************************************************************************************
+ */
+void I2C_DMA_init(void) {
+	SET_BIT(RCC->AHBENR, RCC_AHBENR_DMA1EN); //Тактирование DMA1
+	I2C_DMA_Peripheral_init();
+	I2C_DMA_Head = 0;
+	I2C_DMA_Tail = 0;
+	I2C_DMA_Current = NULL;
+	I2C_DMA_Phase = I2C_DMA_PHASE_IDLE;
+
+	NVIC_SetPriority(I2C1_EV_IRQn, I2C_DMA_IRQ_PRIORITY);
+	NVIC_SetPriority(I2C1_ER_IRQn, I2C_DMA_IRQ_PRIORITY);
+	NVIC_SetPriority(DMA1_Channel6_IRQn, I2C_DMA_IRQ_PRIORITY);
+	NVIC_SetPriority(DMA1_Channel7_IRQn, I2C_DMA_IRQ_PRIORITY);
+	NVIC_EnableIRQ(I2C1_EV_IRQn);
+	NVIC_EnableIRQ(I2C1_ER_IRQn);
+	NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+	NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Поставить запрос в очередь
+ *  @attention Только из основного цикла. Запрос и буфер не трогать, пока Status == I2C_DMA_PENDING.
+ *  @param  *Request - запрос (Status выставляется здесь)
+ *  @retval false - очередь полна или запрос неверный (чтение 0 байт, адрес памяти длиннее 2 байт)
+ **************************************************************************************************
+ */
+bool I2C_DMA_Submit(struct I2C_DMA_Request* Request) {
+	uint32_t Head = I2C_DMA_Head;
+	if ((Request->Read && Request->Size_data == 0) || Request->Size_adress > 2 || Head - I2C_DMA_Tail >= I2C_DMA_QUEUE_SIZE) {
+		I2C_DMA_Stats.Rejected++;
+		return false;
+	}
+	Request->Status = I2C_DMA_PENDING;
+	I2C_DMA_Queue[Head & (I2C_DMA_QUEUE_SIZE - 1)] = Request;
+	__DMB(); //Запрос записан раньше, чем его увидит прерывание
+	I2C_DMA_Head = Head + 1;
+	if (Head + 1 - I2C_DMA_Tail > I2C_DMA_Stats.Queue_max) {
+		I2C_DMA_Stats.Queue_max = Head + 1 - I2C_DMA_Tail;
+	}
+	NVIC_SetPendingIRQ(I2C1_EV_IRQn); //Свободную шину запустит обработчик событий
+	return true;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Контроль таймаута текущего запроса (из основного цикла)
+ **************************************************************************************************
+ */
+void I2C_DMA_Poll(void) {
+	__disable_irq();
+	if (I2C_DMA_Current && SysTimer_ms - I2C_DMA_Start_ms > I2C_DMA_TIMEOUT_MS) {
+		I2C_DMA_Peripheral_init(); //Сброс блока освобождает шину (и STOP от нас уже не нужен)
+		I2C_DMA_Finish(I2C_DMA_TIMEOUT);
+	}
+	__enable_irq();
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Есть ли незавершенные запросы
+ **************************************************************************************************
+ */
+bool I2C_DMA_Busy(void) {
+	return I2C_DMA_Current || I2C_DMA_Tail != I2C_DMA_Head;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Прерывание событий I2C1: автомат обмена
+ *  @attention Сюда же попадаем из I2C_DMA_Submit() (NVIC_SetPendingIRQ) - на свободной
+ *  шине запускается следующий запрос, на занятой лишний вход ничего не меняет:
+ *  чтение одного SR1 флаги не сбрасывает.
+ **************************************************************************************************
+ */
+void I2C1_EV_IRQHandler(void) {
+	uint32_t SR1 = I2C1->SR1;
+	struct I2C_DMA_Request* Request = I2C_DMA_Current;
+
+	switch (I2C_DMA_Phase) {
+	case I2C_DMA_PHASE_IDLE:
+		I2C_DMA_Next();
+		break;
+
+	case I2C_DMA_PHASE_START:
+		if (SR1 & I2C_SR1_SB) {
+			//SB сбрасывается чтением SR1 и записью DR
+			if (Request->Read && Request->Size_adress == 0) {
+				I2C_DMA_Read_Setup();
+				I2C1->DR = (Request->Adress_Device << 1) | 1; //Адрес + Read
+				I2C_DMA_Phase = I2C_DMA_PHASE_READ_ADDRESS;
+			} else {
+				I2C1->DR = Request->Adress_Device << 1; //Адрес + Write
+				I2C_DMA_Phase = I2C_DMA_PHASE_ADDRESS;
+			}
+		}
+		break;
+
+	case I2C_DMA_PHASE_ADDRESS:
+		if (SR1 & I2C_SR1_ADDR) {
+			I2C1->SR2; //ADDR сбрасывается чтением SR1, потом SR2
+			if (Request->Size_adress) {
+				I2C_DMA_Mem_index = 0;
+				I2C_DMA_Phase = I2C_DMA_PHASE_MEM_ADDRESS;
+				SET_BIT(I2C1->CR2, I2C_CR2_ITBUFEN); //TXE уже стоит - сразу вернемся сюда
+			} else if (Request->Size_data) {
+				I2C_DMA_Write_Data();
+			} else {
+				SET_BIT(I2C1->CR1, I2C_CR1_STOP); //Только проверка адреса
+				I2C_DMA_Finish(I2C_DMA_DONE);
+			}
+		}
+		break;
+
+	case I2C_DMA_PHASE_MEM_ADDRESS:
+		if (SR1 & I2C_SR1_TXE) {
+			if (I2C_DMA_Mem_index < Request->Size_adress) {
+				I2C1->DR = (uint8_t) (Request->Adress_data >> (8 * (Request->Size_adress - 1 - I2C_DMA_Mem_index))); //Старший байт первым
+				I2C_DMA_Mem_index++;
+			} else if (Request->Read) {
+				CLEAR_BIT(I2C1->CR2, I2C_CR2_ITBUFEN);
+				I2C_DMA_Phase = I2C_DMA_PHASE_RESTART;
+			} else {
+				I2C_DMA_Write_Data();
+			}
+		}
+		break;
+
+	case I2C_DMA_PHASE_WRITE_END:
+		if (SR1 & I2C_SR1_BTF) {
+			SET_BIT(I2C1->CR1, I2C_CR1_STOP);
+			I2C_DMA_Finish(I2C_DMA_DONE);
+		}
+		break;
+
+	case I2C_DMA_PHASE_RESTART:
+		if (SR1 & I2C_SR1_BTF) {
+			I2C_DMA_Read_Setup();
+			I2C_DMA_Phase = I2C_DMA_PHASE_READ_START;
+			SET_BIT(I2C1->CR1, I2C_CR1_START); //BTF снимется, когда START выйдет на шину
+		}
+		break;
+
+	case I2C_DMA_PHASE_READ_START:
+		if (SR1 & I2C_SR1_SB) {
+			I2C1->DR = (Request->Adress_Device << 1) | 1; //Адрес + Read
+			I2C_DMA_Phase = I2C_DMA_PHASE_READ_ADDRESS;
+		}
+		break;
+
+	case I2C_DMA_PHASE_READ_ADDRESS:
+		if (SR1 & I2C_SR1_ADDR) {
+			if (Request->Size_data == 1) {
+				//Errata: между сбросом ADDR и STOP не должно быть задержки
+				__disable_irq();
+				I2C1->SR2;
+				SET_BIT(I2C1->CR1, I2C_CR1_STOP);
+				__enable_irq();
+				I2C_DMA_Phase = I2C_DMA_PHASE_READ_ONE;
+				SET_BIT(I2C1->CR2, I2C_CR2_ITBUFEN);
+			} else if (Request->Size_data == 2) {
+				__disable_irq();
+				I2C1->SR2;
+				CLEAR_BIT(I2C1->CR1, I2C_CR1_ACK); //С POS = 1: NACK на втором байте
+				__enable_irq();
+				I2C_DMA_Phase = I2C_DMA_PHASE_READ_TWO;
+			} else {
+				I2C_DMA_Phase = I2C_DMA_PHASE_READ_DATA;
+				I2C1->SR2; //Дальше байты забирает DMA
+			}
+		}
+		break;
+
+	case I2C_DMA_PHASE_READ_ONE:
+		if (SR1 & I2C_SR1_RXNE) {
+			Request->data[0] = I2C1->DR;
+			I2C_DMA_Finish(I2C_DMA_DONE);
+		}
+		break;
+
+	case I2C_DMA_PHASE_READ_TWO:
+		if (SR1 & I2C_SR1_BTF) {
+			//Errata: STOP и первое чтение DR - подряд
+			__disable_irq();
+			SET_BIT(I2C1->CR1, I2C_CR1_STOP);
+			Request->data[0] = I2C1->DR;
+			__enable_irq();
+			Request->data[1] = I2C1->DR;
+			I2C_DMA_Finish(I2C_DMA_DONE);
+		}
+		break;
+
+	default:
+		break; //Данные идут через DMA
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Прерывание ошибок I2C1
+ **************************************************************************************************
+ */
+void I2C1_ER_IRQHandler(void) {
+	uint32_t SR1 = I2C1->SR1;
+	if (SR1 & I2C_SR1_AF) {
+		CLEAR_BIT(I2C1->SR1, I2C_SR1_AF);
+		SET_BIT(I2C1->CR1, I2C_CR1_STOP); //Устройство не ответило - освобождаем шину
+		I2C_DMA_Finish(I2C_DMA_NACK);
+	} else if (SR1 & (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR | I2C_SR1_TIMEOUT | I2C_SR1_PECERR)) {
+		I2C_DMA_Peripheral_init(); //Сброс блока сбрасывает и флаги
+		I2C_DMA_Finish(I2C_DMA_ERROR);
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif DMA1 Channel6: передача данных закончена
+ **************************************************************************************************
+ */
+void DMA1_Channel6_IRQHandler(void) {
+	uint32_t ISR = DMA1->ISR;
+	WRITE_REG(DMA1->IFCR, DMA_IFCR_CGIF6);
+	if (ISR & DMA_ISR_TEIF6) {
+		I2C_DMA_Peripheral_init();
+		I2C_DMA_Finish(I2C_DMA_ERROR);
+	} else if ((ISR & DMA_ISR_TCIF6) && I2C_DMA_Phase == I2C_DMA_PHASE_WRITE_DATA) {
+		CLEAR_BIT(I2C1->CR2, I2C_CR2_DMAEN);
+		CLEAR_BIT(DMA1_Channel6->CCR, DMA_CCR_EN);
+		I2C_DMA_Phase = I2C_DMA_PHASE_WRITE_END; //Последний байт еще в сдвиговом регистре - ждем BTF
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif DMA1 Channel7: прием данных закончен
+ **************************************************************************************************
+ */
+void DMA1_Channel7_IRQHandler(void) {
+	uint32_t ISR = DMA1->ISR;
+	WRITE_REG(DMA1->IFCR, DMA_IFCR_CGIF7);
+	if (ISR & DMA_ISR_TEIF7) {
+		I2C_DMA_Peripheral_init();
+		I2C_DMA_Finish(I2C_DMA_ERROR);
+	} else if ((ISR & DMA_ISR_TCIF7) && I2C_DMA_Phase == I2C_DMA_PHASE_READ_DATA) {
+		SET_BIT(I2C1->CR1, I2C_CR1_STOP); //Последний байт уже принят с NACK (LAST)
+		I2C_DMA_Finish(I2C_DMA_DONE);
+	}
+}
+
+#endif
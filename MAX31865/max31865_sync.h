@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ *  @file max31865_sync.h
+ *  @brief Синхронный опрос нескольких MAX31865 (1-shot) с измерением разброса
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  При последовательном опросе в автоматическом режиме каналы разнесены во
+ *  времени на целый цикл опроса (миллисекунды), что портит градиенты и ΔT.
+ *  Здесь все микросхемы на одной шине SPI переводятся в режим 1-shot
+ *  (автопреобразование выключено, VBIAS включен постоянно), и преобразование
+ *  запускается во всех подряд одной плотной последовательностью:
+ *      CS_i вниз -> 0x80, конфигурация с битом 1-shot -> CS_i вверх
+ *  Преобразование стартует по фронту CS вверх, поэтому момент фронта каждого
+ *  канала фиксируется по Clock_Now(). На время последовательности прерывания
+ *  запрещены - разброс определяется только передачей 2 байт на канал
+ *  (единицы мкс при 4.5 MHz); каждая запись ограничена по тактам DWT, канал с
+ *  неудачной записью помечается и в снимок не попадает (Valid = false).
+ *
+ *  Через MAX31865_SYNC_CONVERSION_MS (время 1-shot при фильтре 50 Гц)
+ *  MAX31865_Sync_Collect() читает все каналы и публикует их (reading.h).
+ *  Разброс (последний фронт - первый) и смещения каналов сохраняются в
+ *  снимке; команда "sync" (telemetry.h) выдает последний.
+ *
+ *      MAX31865_Sync_Init(SPI1, CS_table, 3);
+ *      ...
+ *      MAX31865_Sync_Snapshot(SPI1, &Snapshot); //или Trigger / (другая работа) / Collect
+ ******************************************************************************
+ */
+
+#ifndef __MAX31865_SYNC_H
+#define __MAX31865_SYNC_H
+
+#include "MAX31865.h"
+
+#define MAX31865_SYNC_CONVERSION_MS 63 //Время преобразования 1-shot с фильтром 50 Гц (62.5 мс), мс
+#define MAX31865_SYNC_SPI_TIMEOUT_CYCLES 1440 //Предел записи 1-shot одному каналу, такты ядра (~20 мкс на 72 MHz, 2 байта ~3.6 мкс)
+
+//Ножка CS одного канала
+struct MAX31865_CS {
+	GPIO_TypeDef* Port;
+	uint8_t Pin;
+};
+
+//Синхронный снимок всех каналов
+struct MAX31865_Snapshot {
+	uint16_t Code[CHANNEL_COUNT]; //15-битные коды АЦП
+	uint8_t Status[CHANNEL_COUNT]; //Регистры Fault Status
+	uint32_t Trigger_offset[CHANNEL_COUNT]; //Фронт CS канала относительно первого, такты
+	bool Triggered[CHANNEL_COUNT]; //Запись 1-shot каналу прошла (иначе канал не читается)
+	uint32_t Timestamp; //Clock_Now() первого фронта CS
+	uint32_t Skew_cycles; //Разброс запуска: последний фронт - первый, такты Clock_Now() (мкс = / CLOCK_NOW_PER_US)
+	bool Valid; //Запуск и чтение всех каналов прошли без ошибок SPI
+};
+
+extern struct MAX31865_Snapshot MAX31865_Sync_Last; //Последний собранный снимок
+
+void MAX31865_Sync_Init(SPI_TypeDef* SPI, const struct MAX31865_CS* CS_table, uint8_t num_wires); //Настройка CS и перевод всех каналов в 1-shot
+void MAX31865_Sync_Trigger(SPI_TypeDef* SPI, struct MAX31865_Snapshot* Snapshot); //Запуск преобразования во всех каналах подряд
+bool MAX31865_Sync_Collect(SPI_TypeDef* SPI, struct MAX31865_Snapshot* Snapshot); //Чтение и публикация результатов
+bool MAX31865_Sync_Snapshot(SPI_TypeDef* SPI, struct MAX31865_Snapshot* Snapshot); //Trigger + ожидание + Collect
+
+#endif /* __MAX31865_SYNC_H */
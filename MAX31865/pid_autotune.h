@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ *  @file pid_autotune.h
+ *  @brief Автонастройка ПИД-регулятора методом релейной обратной связи (Åström–Hägglund)
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Вместо регулятора на объект подается релейное воздействие:
+ *  выход = Output_bias + Output_step, пока измерение ниже уставки, и
+ *  выход = Output_bias - Output_step, когда выше (с гистерезисом Hysteresis).
+ *  Объект входит в автоколебания, по которым измеряются амплитуда a и период Tu.
+ *  Критический коэффициент: Ku = 4 * d / (pi * sqrt(a^2 - eps^2)), d = Output_step, eps = Hysteresis.
+ *  Из Ku и Tu по выбранному правилу получаются коэффициенты для pid_controller.h.
+ *
+ *  Автомат неблокирующий: PID_Autotune_Step() вызывается на каждое новое измерение
+ *  и сразу возвращает выход. Опрос остальных каналов при этом не останавливается.
+ *  Как и pid_controller, модуль не зависит от железа (собирается и на ПК, см. host/).
+ *
+ *  Единицы те же, что и в pid_controller.h: измерение 0.01 °C, выход - такты ШИМ, время - мс.
+ ******************************************************************************
+ */
+
+#ifndef __PID_AUTOTUNE_H
+#define __PID_AUTOTUNE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid_controller.h"
+
+#define PID_AUTOTUNE_CYCLES 6 //Сколько полных периодов колебаний снимаем (по последним PID_AUTOTUNE_CYCLES - 2 усредняем)
+
+//Состояние автонастройки
+enum PID_Autotune_State {
+	PID_AUTOTUNE_IDLE, //Не запущена
+	PID_AUTOTUNE_RELAY, //Идут релейные колебания
+	PID_AUTOTUNE_DONE, //Коэффициенты рассчитаны
+	PID_AUTOTUNE_FAILED //Таймаут или колебания не получились
+};
+
+//Правило пересчета Ku, Tu в коэффициенты
+enum PID_Autotune_Rule {
+	PID_AUTOTUNE_ZIEGLER_NICHOLS, //Kp = 0.6 Ku, Ti = Tu / 2, Td = Tu / 8 (быстрый, с перерегулированием)
+	PID_AUTOTUNE_TYREUS_LUYBEN //Kp = 0.45 Ku, Ti = 2.2 Tu, Td = Tu / 6.3 (мягкий, для тепловых объектов)
+};
+
+//Структура автонастройки
+struct PID_Autotune {
+	/*----------Параметры----------*/
+	int32_t Setpoint; //Уставка, вокруг которой идут колебания, 0.01 °C
+	int32_t Hysteresis; //Гистерезис реле (больше шума измерения), 0.01 °C
+	int32_t Output_bias; //Среднее значение выхода
+	int32_t Output_step; //Амплитуда реле d
+	uint32_t Sample_period_ms; //Период вызова регулятора (для пересчета Ki, Kd на один шаг)
+	uint32_t Timeout_ms; //Максимальная длительность автонастройки
+	uint8_t Rule; //enum PID_Autotune_Rule
+	/*----------Состояние----------*/
+	uint8_t State; //enum PID_Autotune_State
+	bool Relay_high; //Текущее состояние реле
+	uint8_t Cycles; //Сколько периодов уже снято
+	uint32_t Start_ms; //Время запуска
+	uint32_t Last_rise_ms; //Время последнего переключения реле вверх
+	int32_t Peak_max; //Максимум измерения за текущий период
+	int32_t Peak_min; //Минимум измерения за текущий период
+	uint32_t Period_sum_ms; //Сумма периодов (для усреднения)
+	int64_t Amplitude_sum; //Сумма размахов (max - min)
+	/*----------Результат----------*/
+	uint32_t Tu_ms; //Период автоколебаний
+	int32_t Amplitude; //Амплитуда автоколебаний a, 0.01 °C
+	float Ku; //Критический коэффициент, тактов ШИМ на 0.01 °C
+	int32_t Kp, Ki, Kd; //Коэффициенты для PID_Set_Tunings(), Q16.16
+};
+
+void PID_Autotune_Start(struct PID_Autotune* AT, uint32_t Time_ms); //Запуск (параметры должны быть заполнены)
+int32_t PID_Autotune_Step(struct PID_Autotune* AT, int32_t Measurement, uint32_t Time_ms); //Шаг автомата. Возвращает выход
+void PID_Autotune_Apply(const struct PID_Autotune* AT, struct PID_Controller* PID, int32_t Measurement); //Перенос результата в регулятор и безударный переход в автомат
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PID_AUTOTUNE_H */
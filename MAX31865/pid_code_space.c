@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ *  @file pid_code_space.c
+ *  @brief ПИД-регулирование напрямую в кодах АЦП MAX31865
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание метода см. pid_code_space.h
+ *  double используется только в линеаризации (при смене уставки), не в шаге регулятора.
+ ******************************************************************************
+ */
+
+#include "pid_code_space.h"
+#include "pipeline.h"
+
+#define PID_CODE_SPACE_FULL_SCALE 32768.0 //15 бит АЦП MAX31865
+#define PID_CODE_SPACE_DELTA_T    0.5     //Шаг для расчета наклона (центральная разность), °C
+
+/*
+ **************************************************************************************************
+ *  @breif Температура -> код АЦП MAX31865
+ *  @param  *CS - параметры пересчета
+ *  @param  Temperature - температура, °C
+ *  @retval Возвращает 15-битный код, ограниченный 0...32767
+ **************************************************************************************************
+ */
+uint16_t PID_Code_Space_Temperature_To_Code(const struct PID_Code_Space* CS, float Temperature) {
+	double Code = Pipeline_Code_degC(CS->Channel, Temperature) + 0.5;
+	if (Code < 0.0) {
+		return 0;
+	}
+	if (Code > PID_CODE_SPACE_FULL_SCALE - 1.0) {
+		return (uint16_t) (PID_CODE_SPACE_FULL_SCALE - 1.0);
+	}
+	return (uint16_t) Code;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Пересчет уставки и коэффициентов регулятора в коды АЦП
+ *  @attention Вызывать после изменения коэффициентов или калибровки канала (Channel_Set_Calibration()).
+ *  Интегратор регулятора хранит сумму Ki * e в единицах выхода, поэтому пересчет безударный.
+ *  Знак: код растет с температурой (у Pt наклон положительный), так что направление действия
+ *  регулятора сохраняется.
+ *  @param  *CS - параметры пересчета
+ *  @param  *PID - регулятор, на вход которого подается MAX31865_Get_Code()
+ **************************************************************************************************
+ */
+void PID_Code_Space_Linearise(struct PID_Code_Space* CS, struct PID_Controller* PID) {
+	double Slope = (Pipeline_Code_degC(CS->Channel, CS->Setpoint + PID_CODE_SPACE_DELTA_T) - Pipeline_Code_degC(CS->Channel, CS->Setpoint - PID_CODE_SPACE_DELTA_T)) / (2.0 * PID_CODE_SPACE_DELTA_T);
+	CS->Codes_per_degC = (float) Slope;
+
+	//Коэффициенты заданы на 0.01 °C ошибки: 1 код = 100 / Slope сотых градуса
+	double Scale = 100.0 / Slope;
+	PID_Set_Tunings(PID, (int32_t) (CS->Kp * Scale + 0.5), (int32_t) (CS->Ki * Scale + 0.5), (int32_t) (CS->Kd * Scale + 0.5));
+	PID->Setpoint = PID_Code_Space_Temperature_To_Code(CS, CS->Setpoint);
+	CS->Valid = true;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Смена уставки регулятора, работающего в кодах АЦП
+ *  @attention Линеаризация выполняется только если уставка действительно изменилась.
+ *  @param  *CS - параметры пересчета
+ *  @param  *PID - регулятор
+ *  @param  Setpoint - новая уставка, °C
+ **************************************************************************************************
+ */
+void PID_Code_Space_Set_Setpoint(struct PID_Code_Space* CS, struct PID_Controller* PID, float Setpoint) {
+	if (CS->Valid && Setpoint == CS->Setpoint) {
+		return;
+	}
+	CS->Setpoint = Setpoint;
+	PID_Code_Space_Linearise(CS, PID);
+}
@@ -0,0 +1,141 @@
+/**
+ ******************************************************************************
+ *  @file pid_controller.c
+ *  @brief ПИД-регулятор в фиксированной точке
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Все вычисления целочисленные: умножение 32x32->64 на Cortex-M3 - одна инструкция SMULL,
+ *  плавающей точки и деления в шаге регулятора нет.
+ *  Подробности по единицам и режимам см. pid_controller.h
+ ******************************************************************************
+ */
+
+#include "pid_controller.h"
+
+/*
+ **************************************************************************************************
+ *  @breif Ограничение 64-битного значения диапазоном
+ **************************************************************************************************
+ */
+static inline int64_t PID_Clamp(int64_t Value, int64_t Min, int64_t Max) {
+	if (Value > Max) {
+		return Max;
+	}
+	if (Value < Min) {
+		return Min;
+	}
+	return Value;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Инициализация ПИД-регулятора
+ *  @attention Регулятор стартует в ручном режиме с выходом Out_min.
+ *  Для запуска регулирования вызовите PID_Set_Automatic() с текущим измерением.
+ *  @param  *PID - структура регулятора
+ *  @param  Kp, Ki, Kd - коэффициенты в формате Q16.16 (см. PID_Q16())
+ *  @param  Out_min, Out_max - диапазон выхода
+ *  @param  Slew_max - максимальное изменение выхода за шаг (0 - без ограничения)
+ **************************************************************************************************
+ */
+void PID_Init(struct PID_Controller* PID, int32_t Kp, int32_t Ki, int32_t Kd, int32_t Out_min, int32_t Out_max, int32_t Slew_max) {
+	PID->Kp = Kp;
+	PID->Ki = Ki;
+	PID->Kd = Kd;
+	PID->Setpoint = 0;
+	PID->Out_min = Out_min;
+	PID->Out_max = Out_max;
+	PID->Slew_max = Slew_max;
+	PID->Integrator = 0;
+	PID->Last_measurement = 0;
+	PID->Output = Out_min;
+	PID->Automatic = false;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Смена коэффициентов регулятора
+ *  @attention Интегратор хранит накопленную сумму Ki * e, а не сумму ошибок,
+ *  поэтому смена Ki не вызывает скачка выхода.
+ **************************************************************************************************
+ */
+void PID_Set_Tunings(struct PID_Controller* PID, int32_t Kp, int32_t Ki, int32_t Kd) {
+	PID->Kp = Kp;
+	PID->Ki = Ki;
+	PID->Kd = Kd;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Перевод регулятора в ручной режим
+ *  @param  *PID - структура регулятора
+ *  @param  Output - значение выхода, которое будет держаться до перехода в автомат
+ **************************************************************************************************
+ */
+void PID_Set_Manual(struct PID_Controller* PID, int32_t Output) {
+	PID->Automatic = false;
+	PID->Output = (int32_t) PID_Clamp(Output, PID->Out_min, PID->Out_max);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Безударный переход в автоматический режим
+ *  @attention Интегратор подгоняется так, чтобы первый автоматический шаг выдал тот же выход,
+ *  что был в ручном режиме. D-составляющая стартует с нуля (Last_measurement = Measurement).
+ *  @param  *PID - структура регулятора
+ *  @param  Measurement - текущее измерение, 0.01 °C
+ **************************************************************************************************
+ */
+void PID_Set_Automatic(struct PID_Controller* PID, int32_t Measurement) {
+	if (!PID->Automatic) {
+		int64_t P = (int64_t) PID->Kp * (PID->Setpoint - Measurement);
+		PID->Integrator = PID_Clamp(((int64_t) PID->Output << 16) - P, (int64_t) PID->Out_min << 16, (int64_t) PID->Out_max << 16);
+		PID->Last_measurement = Measurement;
+		PID->Automatic = true;
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Один шаг ПИД-регулятора
+ *  @attention Вызывается один раз на каждое новое измерение (период дискретизации = период опроса).
+ *  В ручном режиме только отслеживает измерение и возвращает заданный выход.
+ *  @param  *PID - структура регулятора
+ *  @param  Measurement - измерение, 0.01 °C
+ *  @retval Возвращает новое значение выхода
+ **************************************************************************************************
+ */
+RAMFUNC int32_t PID_Compute(struct PID_Controller* PID, int32_t Measurement) {
+	if (!PID->Automatic) {
+		PID->Last_measurement = Measurement;
+		return PID->Output;
+	}
+
+	int32_t Error = PID->Setpoint - Measurement;
+	int64_t Out_min_q = (int64_t) PID->Out_min << 16;
+	int64_t Out_max_q = (int64_t) PID->Out_max << 16;
+
+	int64_t P = (int64_t) PID->Kp * Error;
+	int64_t D = -(int64_t) PID->Kd * (Measurement - PID->Last_measurement); //D по измерению
+	int64_t Integrator = PID_Clamp(PID->Integrator + (int64_t) PID->Ki * Error, Out_min_q, Out_max_q);
+	PID->Last_measurement = Measurement;
+
+	//Округление Q16.16 -> целое
+	int64_t Unlimited = (P + Integrator + D + 0x8000) >> 16;
+	int64_t Output = PID_Clamp(Unlimited, PID->Out_min, PID->Out_max);
+
+	//Ограничение скорости изменения выхода
+	if (PID->Slew_max > 0) {
+		Output = PID_Clamp(Output, (int64_t) PID->Output - PID->Slew_max, (int64_t) PID->Output + PID->Slew_max);
+	}
+
+	//Anti-windup: если выход ограничен в сторону ошибки, интегратор не накапливаем
+	if (!((Unlimited > Output && Error > 0) || (Unlimited < Output && Error < 0))) {
+		PID->Integrator = Integrator;
+	}
+
+	PID->Output = (int32_t) Output;
+	return PID->Output;
+}
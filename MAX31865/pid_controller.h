@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ *  @file pid_controller.h
+ *  @brief ПИД-регулятор в фиксированной точке
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Регулятор не зависит от железа (только stdint), поэтому его можно собрать и на ПК.
+ *  Привязка к MAX31865 и ШИМ TIM3 находится в heater_control.c
+ *
+ *  Единицы:
+ *  - Измерение и уставка: сотые доли °C (int32_t). 25.00 °C = 2500.
+ *  - Выход: такты ШИМ (значение для TIMx->CCRx), ограничен Out_min...Out_max.
+ *  - Коэффициенты Kp, Ki, Kd: формат Q16.16 (1.0 = 65536), размерность "тактов ШИМ на 0.01 °C".
+ *    Ki и Kd уже учитывают период дискретизации (Ki = Kp * Ts / Ti, Kd = Kp * Td / Ts).
+ *
+ *  Что реализовано:
+ *  - Anti-windup: интегратор ограничен диапазоном выхода и не накапливается,
+ *    когда выход уперся в ограничение (или в ограничение скорости) в сторону ошибки.
+ *  - Дифференциальная составляющая по измерению, а не по ошибке (нет удара при смене уставки).
+ *  - Безударный переход из ручного режима в автоматический.
+ *  - Ограничение скорости изменения выхода (Slew_max тактов за один шаг).
+ *  Интегратор хранит сумму Ki * e, поэтому смена коэффициентов налету тоже безударная.
+ ******************************************************************************
+ */
+
+#ifndef __PID_CONTROLLER_H
+#define __PID_CONTROLLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ramfunc.h"
+
+#define PID_Q16(x) ((int32_t)((x) * 65536.0)) //Перевод коэффициента в формат Q16.16 (только для констант)
+
+//Структура ПИД-регулятора
+struct PID_Controller {
+	int32_t Kp; //Пропорциональный коэффициент, Q16.16
+	int32_t Ki; //Интегральный коэффициент (на один шаг), Q16.16
+	int32_t Kd; //Дифференциальный коэффициент (на один шаг), Q16.16
+	int32_t Setpoint; //Уставка, 0.01 °C
+	int32_t Out_min; //Минимальное значение выхода
+	int32_t Out_max; //Максимальное значение выхода
+	int32_t Slew_max; //Максимальное изменение выхода за шаг (0 - без ограничения)
+	int64_t Integrator; //Интегральная составляющая, Q16.16 в единицах выхода
+	int32_t Last_measurement; //Предыдущее измерение (для D по измерению)
+	int32_t Output; //Текущий выход
+	bool Automatic; //true - автоматический режим, false - ручной
+};
+
+void PID_Init(struct PID_Controller* PID, int32_t Kp, int32_t Ki, int32_t Kd, int32_t Out_min, int32_t Out_max, int32_t Slew_max); //Инициализация регулятора (в ручном режиме, выход = Out_min)
+void PID_Set_Tunings(struct PID_Controller* PID, int32_t Kp, int32_t Ki, int32_t Kd); //Смена коэффициентов налету
+void PID_Set_Manual(struct PID_Controller* PID, int32_t Output); //Ручной режим с заданным выходом
+void PID_Set_Automatic(struct PID_Controller* PID, int32_t Measurement); //Безударный переход в автоматический режим
+RAMFUNC int32_t PID_Compute(struct PID_Controller* PID, int32_t Measurement); //Один шаг регулятора. Возвращает новый выход
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PID_CONTROLLER_H */
@@ -0,0 +1,265 @@
+/**
+ ******************************************************************************
+ *  @file pipeline.c
+ *  @brief Обработка измерения после чтения кода: калибровка, температура, аварии, регулятор
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. pipeline.h. Без обращений к железу - собирается и на ПК (host/replay.c).
+ ******************************************************************************
+ */
+
+#include "pipeline.h"
+#include "channel_table.h"
+#include "fault_log.h"
+
+/*
+ **************************************************************************************************
+ *  @breif Пересчет и публикация измерения канала, у которого уже есть код, статус и время
+ *  @param  Channel - номер канала
+ *  @param  *Reading - заполнены Code, Status, Timestamp; остальные поля заполняются здесь
+ **************************************************************************************************
+ */
+RAMFUNC void Pipeline_Publish(uint8_t Channel, struct Reading* Reading) {
+	Channel_Update(Channel, Reading->Code, Reading->Status, Reading->Timestamp);
+	Reading->Resistance = ((double) Channel_Calibrated_Code_Q15(Channel, Reading->Code) * MAX31865_R_REF ) / (double) (32768.0 * 32768.0); //Калибровка канала (channel_table.h)
+	Reading->Temperature = Get_Temperature_PT(Reading->Resistance, MAX31865_PT100_R0, PT_385);
+	Reading->Sequence = Reading_Publish(Channel, Reading);
+	Fault_Log_Record(Channel, Reading->Status); //Расшифровка и журнал (fault_log.h), без обращений к SPI
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Температура в сотых долях градуса для регулятора (pid_controller.h)
+ *  @retval Температура, 0.01 °C, с округлением к ближайшему
+ **************************************************************************************************
+ */
+int32_t Pipeline_Centi_degC(float Temperature) {
+	return (int32_t) (Temperature * 100.0f + (Temperature < 0.0f ? -0.5f : 0.5f));
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Настройка регулятора нагревателя: одна для прошивки (Heater_Control_init()) и host/replay.c
+ *  @attention Регулятор остается в ручном режиме с нулевым выходом - переход в автомат по
+ *  первому измерению (PID_Set_Automatic()).
+ *  @param  Setpoint - уставка, 0.01 °C
+ **************************************************************************************************
+ */
+void Pipeline_Heater_Init(struct PID_Controller* PID, int32_t Setpoint) {
+	PID_Init(PID, HEATER_PID_KP, HEATER_PID_KI, HEATER_PID_KD, 0, HEATER_PWM_PERIOD, HEATER_PID_SLEW_MAX);
+	PID->Setpoint = Setpoint;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Логика аварии канала на новую выборку
+ *  @attention Только целые - годится для прерывания DRDY.
+ *  @param  *Trip - настройка и состояние аварии канала
+ *  @param  Code - 15-битный код АЦП
+ *  @param  Status - регистр Fault Status (0 - нет ошибки)
+ *  @retval Авария канала активна
+ **************************************************************************************************
+ */
+bool Pipeline_Trip_Step(struct Trip_Channel* Trip, uint16_t Code, uint8_t Status) {
+	if (!Trip->Enabled) {
+		return Trip->Tripped;
+	}
+
+	bool Fault = Trip->On_fault && Status;
+	bool Outside = Code > Trip->High_code || Code < Trip->Low_code || Fault;
+	bool Inside = Code <= Trip->High_code - Trip->Hysteresis && Code >= Trip->Low_code + Trip->Hysteresis && !Fault;
+
+	if (Outside) {
+		if (Trip->Counter < UINT8_MAX) {
+			Trip->Counter++;
+		}
+		if (!Trip->Tripped && Trip->Counter >= Trip->Delay_on) {
+			Trip->Tripped = true;
+			Trip->Trip_count++;
+		}
+	} else {
+		Trip->Counter = 0;
+		if (Trip->Tripped && Inside && !Trip->Latching) {
+			Trip->Tripped = false;
+		}
+	}
+	return Trip->Tripped;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Температура в °C -> код АЦП канала (обратная калибровка, без округления)
+ **************************************************************************************************
+ */
+double Pipeline_Code_degC(uint8_t Channel, float Temperature) {
+	double Gain = (double) Channel_Table.Cal_gain[Channel] / CHANNEL_GAIN_ONE;
+	double Offset = (double) Channel_Table.Cal_offset[Channel];
+	return (Get_Resistance_PT(Temperature, MAX31865_PT100_R0, PT_385) * 32768.0 / MAX31865_R_REF - Offset) / Gain;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Наклон характеристики в точке: мК на один калиброванный код
+ *  @attention double - редко (delta_t.c). Центральная разность по сопротивлению ±Step, °C.
+ *  Калиброванный код (Channel_Calibrated_Code_Q15() / 32768) пропорционален сопротивлению,
+ *  поэтому наклон от калибровки канала не зависит.
+ *  @param  Code - калиброванный код
+ *  @retval мК/код, Q16
+ **************************************************************************************************
+ */
+int32_t Pipeline_mK_per_code_Q16(int32_t Code, double Step) {
+	double Resistance = (double) Code * MAX31865_R_REF / 32768.0;
+	double Temperature = Get_Temperature_PT(Resistance, MAX31865_PT100_R0, PT_385);
+	double dR = Get_Resistance_PT(Temperature + Step, MAX31865_PT100_R0, PT_385) - Get_Resistance_PT(Temperature - Step, MAX31865_PT100_R0, PT_385);
+	double Codes_per_degC = dR / (2.0 * Step) * 32768.0 / MAX31865_R_REF;
+
+	return (int32_t) (1000.0 * 65536.0 / Codes_per_degC);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Разность калиброванных кодов двух каналов, Q8 (коды * 256)
+ *  @attention Только целые: каждый код со своей калибровкой (Cal_gain, Cal_offset) в Q15,
+ *  разность в int64 и сдвиг до Q8. Разница смещений датчиков вычитается до разности.
+ **************************************************************************************************
+ */
+int32_t Pipeline_Delta_code_Q8(uint8_t Channel_a, uint16_t Code_a, uint8_t Channel_b, uint16_t Code_b) {
+	int64_t Delta_Q15 = (int64_t) Channel_Calibrated_Code_Q15(Channel_a, Code_a) - (int64_t) Channel_Calibrated_Code_Q15(Channel_b, Code_b);
+	return (int32_t) (Delta_Q15 / 128);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Пределы аварии в °C с переводом в коды АЦП
+ *  @attention double - при настройке, не в прерывании. Учитывает калибровку канала.
+ **************************************************************************************************
+ */
+void Pipeline_Trip_Limits_degC(struct Trip_Channel* Trip, uint8_t Channel, float Low, float High, float Hysteresis) {
+	double Gain = (double) Channel_Table.Cal_gain[Channel] / CHANNEL_GAIN_ONE;
+	double Code_low = Pipeline_Code_degC(Channel, Low);
+	double Code_high = Pipeline_Code_degC(Channel, High);
+	double Code_hyst = (Get_Resistance_PT(High, MAX31865_PT100_R0, PT_385) - Get_Resistance_PT(High - Hysteresis, MAX31865_PT100_R0, PT_385)) * 32768.0 / MAX31865_R_REF / Gain;
+
+	Trip->Low_code = (uint16_t) (Code_low < 0.0 ? 0.0 : Code_low + 0.5);
+	Trip->High_code = (uint16_t) (Code_high > 32767.0 ? 32767.0 : Code_high + 0.5);
+	Trip->Hysteresis = (uint16_t) (Code_hyst + 0.5);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Пределы прогноза в °C и горизонт предварительной аварии
+ *  @attention double - при настройке. Decimation и Ticks_per_ms задаются до вызова.
+ *  Окно начинается заново.
+ *  @param  Horizon_s - предварительная авария, если до предела осталось не больше, с
+ **************************************************************************************************
+ */
+void Pipeline_Trend_Limits_degC(struct Trend_Channel* Trend, uint8_t Channel, float Low, float High, uint32_t Horizon_s) {
+	double Code_low = Pipeline_Code_degC(Channel, Low);
+	double Code_high = Pipeline_Code_degC(Channel, High);
+
+	Trend->Low_code = (uint16_t) (Code_low < 0.0 ? 0.0 : Code_low + 0.5);
+	Trend->High_code = (uint16_t) (Code_high > 32767.0 ? 32767.0 : Code_high + 0.5);
+	Trend->Horizon_ms = Horizon_s * 1000;
+	if (Trend->Decimation == 0) {
+		Trend->Decimation = 1;
+	}
+	Trend->Points = 0;
+	Trend->Head = 0;
+	Trend->Accumulated = 0;
+	Trend->Accumulator = 0;
+	Trend->Sum = 0;
+	Trend->Weighted = 0;
+	Trend->Interval = 0;
+	Trend->Time_to_limit_ms = UINT32_MAX;
+	Trend->Pre_alarm = false;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Новая выборка в прогноз выхода за пределы (описание - pipeline.h)
+ *  @attention На выборку - сложение; раз в Decimation выборок - окно за O(1) и несколько
+ *  операций double. Ошибка датчика начинает окно заново и снимает предварительную аварию
+ *  (ее ловит авария в кодах с On_fault).
+ *  @param  *Trend - настройка и состояние прогноза канала
+ *  @param  *Reading - заполнены Code, Status, Timestamp
+ *  @retval Предварительная авария активна
+ **************************************************************************************************
+ */
+bool Pipeline_Trend_Step(struct Trend_Channel* Trend, const struct Reading* Reading) {
+	if (!Trend->Enabled) {
+		return Trend->Pre_alarm;
+	}
+	if (Reading->Status) {
+		Trend->Points = 0;
+		Trend->Head = 0;
+		Trend->Accumulated = 0;
+		Trend->Accumulator = 0;
+		Trend->Sum = 0;
+		Trend->Weighted = 0;
+		Trend->Interval = 0;
+		Trend->Time_to_limit_ms = UINT32_MAX;
+		Trend->Pre_alarm = false;
+		return false;
+	}
+
+	Trend->Accumulator += Reading->Code;
+	if (++Trend->Accumulated < Trend->Decimation) {
+		return Trend->Pre_alarm;
+	}
+	uint32_t Point = Trend->Accumulator;
+	Trend->Accumulator = 0;
+	Trend->Accumulated = 0;
+
+	//Средний интервал между точками: скользящее среднее с весом 1/8
+	if (Trend->Points) {
+		uint32_t Interval = Reading->Timestamp - Trend->Point_timestamp;
+		Trend->Interval = Trend->Interval ? (uint32_t) ((int64_t) Trend->Interval + ((int64_t) Interval - Trend->Interval) / 8) : Interval; //int64: интервал до полного периода Timestamp
+	}
+	Trend->Point_timestamp = Reading->Timestamp;
+
+	//Окно за O(1)
+	if (Trend->Points < TREND_WINDOW) {
+		Trend->Window[Trend->Points] = Point;
+		Trend->Weighted += (int64_t) Trend->Points * Point;
+		Trend->Sum += Point;
+		Trend->Points++;
+		if (Trend->Points < TREND_WINDOW) {
+			return Trend->Pre_alarm;
+		}
+	} else {
+		uint32_t Old = Trend->Window[Trend->Head];
+		Trend->Weighted += (int64_t) (TREND_WINDOW - 1) * Point - (int64_t) (Trend->Sum - Old);
+		Trend->Sum += Point - Old;
+		Trend->Window[Trend->Head] = Point;
+		Trend->Head = (uint8_t) ((Trend->Head + 1) % TREND_WINDOW);
+	}
+
+	//Наклон (единиц точки на точку) и значение по прямой в последней точке
+	const int64_t Sum_k = (int64_t) TREND_WINDOW * (TREND_WINDOW - 1) / 2;
+	const int64_t Denominator = (int64_t) TREND_WINDOW * TREND_WINDOW * (TREND_WINDOW * TREND_WINDOW - 1) / 12;
+	double Slope = (double) ((int64_t) TREND_WINDOW * Trend->Weighted - Sum_k * (int64_t) Trend->Sum) / (double) Denominator;
+	double Fit = (double) Trend->Sum / TREND_WINDOW + Slope * ((TREND_WINDOW - 1) / 2.0);
+
+	double Points_left = -1.0; //До предела, точек (< 0 - не приближаемся)
+	if (Slope > 0.0) {
+		Points_left = ((double) Trend->High_code * Trend->Decimation - Fit) / Slope;
+	} else if (Slope < 0.0) {
+		Points_left = ((double) Trend->Low_code * Trend->Decimation - Fit) / Slope;
+	}
+	if (Slope != 0.0 && Points_left < 0.0) {
+		Points_left = 0.0; //Уже за пределом
+	}
+
+	double Ms = Points_left * Trend->Interval / Trend->Ticks_per_ms;
+	Trend->Time_to_limit_ms = (Points_left < 0.0 || Ms >= (double) UINT32_MAX) ? UINT32_MAX : (uint32_t) Ms;
+
+	if (!Trend->Pre_alarm && Trend->Time_to_limit_ms <= Trend->Horizon_ms) {
+		Trend->Pre_alarm = true;
+		Trend->Pre_alarm_count++;
+	} else if (Trend->Pre_alarm && Trend->Time_to_limit_ms > Trend->Horizon_ms + Trend->Horizon_ms / 4) {
+		Trend->Pre_alarm = false;
+	}
+	return Trend->Pre_alarm;
+}
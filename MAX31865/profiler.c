@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ *  @file profiler.c
+ *  @brief Профилировщик горячих участков по счетчику тактов DWT (Clock_Now())
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. profiler.h. Файл пустой, пока не определен USE_PROFILER.
+ ******************************************************************************
+ */
+
+#include "profiler.h"
+
+#if defined (USE_PROFILER)
+
+#include "stm32f103xx_CMSIS.h"
+
+struct Profiler_Region Profiler_Table[PROFILER_REGIONS_COUNT]; //Таблица статистики по участкам
+
+//Имена участков для выгрузки (порядок как в enum в profiler.h)
+static const char* const Profiler_Names[PROFILER_REGIONS_COUNT] = {
+	"get_code",
+	"spi_tx",
+	"spi_rx",
+	"conversion",
+	"read_convert",
+	"heater",
+	"systick_irq",
+	"usart1_irq"
+};
+
+/*
+ **************************************************************************************************
+ *  @breif Очистка таблицы профилировщика
+ **************************************************************************************************
+ */
+void Profiler_Reset(void) {
+	for (uint32_t i = 0; i < PROFILER_REGIONS_COUNT; i++) {
+		__disable_irq(); //Участки из прерываний не должны писать в полуочищенную запись
+		Profiler_Table[i].Count = 0;
+		Profiler_Table[i].Min = UINT32_MAX;
+		Profiler_Table[i].Max = 0;
+		Profiler_Table[i].Sum = 0;
+		for (uint32_t j = 0; j < PROFILER_HISTOGRAM_SIZE; j++) {
+			Profiler_Table[i].Histogram[j] = 0;
+		}
+		__enable_irq();
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запуск профилировщика
+ **************************************************************************************************
+ */
+void Profiler_Init(void) {
+	CMSIS_DWT_Cycle_Counter_init();
+	Profiler_Reset();
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Дописать строку в буфер
+ *  @retval Возвращает указатель на конец строки
+ **************************************************************************************************
+ */
+static char* Profiler_Append_String(char* Buffer, const char* String) {
+	while (*String) {
+		*Buffer++ = *String++;
+	}
+	return Buffer;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Дописать беззнаковое число в буфер (без printf, чтобы не тянуть его в прошивку)
+ *  @retval Возвращает указатель на конец строки
+ **************************************************************************************************
+ */
+static char* Profiler_Append_Uint(char* Buffer, uint64_t Value) {
+	char Digits[20];
+	uint8_t Count = 0;
+	do {
+		Digits[Count++] = (char) ('0' + Value % 10);
+		Value /= 10;
+	} while (Value);
+	while (Count) {
+		*Buffer++ = Digits[--Count];
+	}
+	return Buffer;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Выгрузка таблицы профилировщика по USART
+ *  @attention Формат одной строки (значения в тактах ядра):
+ *  имя count=N min=N max=N avg=N h[i]=N ... (только ненулевые корзины гистограммы)
+ *  Передача блокирующая - вызывать по запросу, а не в горячем цикле.
+ *  @param  *USART - USART, в который выгружаем
+ **************************************************************************************************
+ */
+void Profiler_Dump(USART_TypeDef* USART) {
+	char Line[64];
+	char* End;
+
+	for (uint32_t i = 0; i < PROFILER_REGIONS_COUNT; i++) {
+		struct Profiler_Region R;
+		__disable_irq(); //Снимок записи целиком
+		R = Profiler_Table[i];
+		__enable_irq();
+
+		End = Profiler_Append_String(Line, Profiler_Names[i]);
+		End = Profiler_Append_String(End, " count=");
+		End = Profiler_Append_Uint(End, R.Count);
+		End = Profiler_Append_String(End, " min=");
+		End = Profiler_Append_Uint(End, R.Count ? R.Min : 0);
+		End = Profiler_Append_String(End, " max=");
+		End = Profiler_Append_Uint(End, R.Max);
+		End = Profiler_Append_String(End, " avg=");
+		End = Profiler_Append_Uint(End, R.Count ? R.Sum / R.Count : 0);
+		CMSIS_USART_Transmit(USART, (uint8_t*) Line, (uint16_t) (End - Line), 100);
+
+		for (uint32_t j = 0; j < PROFILER_HISTOGRAM_SIZE; j++) {
+			if (R.Histogram[j]) {
+				End = Profiler_Append_String(Line, " h");
+				End = Profiler_Append_Uint(End, j);
+				*End++ = '=';
+				End = Profiler_Append_Uint(End, R.Histogram[j]);
+				CMSIS_USART_Transmit(USART, (uint8_t*) Line, (uint16_t) (End - Line), 100);
+			}
+		}
+		CMSIS_USART_Transmit(USART, (uint8_t*) "\r\n", 2, 100);
+	}
+}
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ ******************************************************************************
+ *  @file pwm_sync.h
+ *  @brief Запуск 1-shot преобразования MAX31865 в заданной фазе ШИМ нагревателя
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Переключения ключа нагревателя (TIM3 CH1, heater_control.h) наводятся на
+ *  провода ТС. В авто-режиме MAX31865 преобразования идут сами по себе, фаза ШИМ
+ *  относительно окна преобразования каждый раз случайная - наводка выглядит как
+ *  шум, и его приходится усреднять.
+ *
+ *  Здесь MAX31865 переводится в режим 1-shot (VBIAS включен постоянно, фильтр 50 Гц),
+ *  а запуск делает прерывание сравнения TIM3 CH2 (тот же счетчик, что и ШИМ, вывод
+ *  CH2 не используется): CS, запись бита 1-shot, CS - преобразование стартует по
+ *  фронту CS в заданной точке периода ШИМ.
+ *  Одной фазы запуска мало: ШИМ 1 кГц (HEATER_PWM_PERIOD, pipeline.h), а преобразование
+ *  идет 62.5 мс - это ~62 периода ШИМ, и CCR1 меняется на каждом шаге регулятора (до 10%
+ *  за шаг), так что число и положение фронтов ключа в окне преобразования зависят от
+ *  скважности. Поэтому на время преобразования нагреватель держится выключенным: то же
+ *  прерывание переводит OC1 в принудительно неактивное состояние (OC1M = 0b100), а
+ *  PWM_Sync_Take_Sample() по окончании преобразования возвращает режим ШИМ. Окно
+ *  преобразования свободно от фронтов ключа, одиночные преобразования пригодны без
+ *  усреднения. Запуск в паузе ШИМ (PWM_SYNC_PHASE_OFF_MIDDLE) - выход и так в нуле, и
+ *  выключение не дает фронта; фаза внутри импульса дает спад прямо перед фронтом CS.
+ *  Цена - нагреватель выключен 62.5 мс на каждую выборку: наибольшая средняя мощность
+ *  (1 - 62.5 мс / период выборок) от полной (при цикле main.c ~200 мс - около 70%).
+ *  Регулятор (интегратор) компенсирует это в пределах запаса, автонастройка видит
+ *  амплитуду реле, уменьшенную в ту же долю.
+ *  Фаза - в тактах TIM3 (мкс) от начала периода, или PWM_SYNC_PHASE_OFF_MIDDLE -
+ *  середина паузы по текущему TIM3->CCR1, пересчитывается перед каждым запуском.
+ *
+ *  Основной цикл зовет PWM_Sync_Take_Sample(): пока преобразование не готово -
+ *  сразу false; готово - чтение регистров, выборка (Timestamp - фронт запуска) и
+ *  постановка следующего запуска на ближайшее совпадение фазы. Прерывание TIM3
+ *  разрешено только между постановкой и запуском - 1 раз на выборку, а не каждый период.
+ *
+ *  SPI1 к MAX31865 на время постановки принадлежит прерыванию - основной цикл
+ *  читает датчик только через PWM_Sync_Take_Sample(). С USE_TRIP не совместим
+ *  (там SPI1 читает прерывание DRDY).
+ ******************************************************************************
+ */
+
+#ifndef __PWM_SYNC_H
+#define __PWM_SYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "heater_control.h" //HEATER_PWM_PERIOD, TIM3
+
+/*----------Включение запуска по фазе ШИМ----------*/
+//#define USE_PWM_SYNC   //Раскомментировать: 1-shot по сравнению TIM3 CH2, основной цикл берет выборки через PWM_Sync_Take_Sample()
+/*----------Включение запуска по фазе ШИМ----------*/
+
+#define PWM_SYNC_PHASE_OFF_MIDDLE 0xFFFF //Фаза: середина паузы ШИМ (по TIM3->CCR1)
+#define PWM_SYNC_OC1M_PWM         0b110  //OC1M нагревателя: PWM mode 1 (как в Heater_Control_init())
+#define PWM_SYNC_OC1M_OFF         0b100  //OC1M нагревателя на время преобразования: Force inactive level
+#define PWM_SYNC_CONVERSION_MS    63     //1-shot с фильтром 50 Гц: 62.5 мс
+#define PWM_SYNC_IRQ_PRIORITY     1      //Ниже аварий, выше SysTick и USART
+#define PWM_SYNC_SPI_TIMEOUT_CYCLES 1440 //Предел записи 1-shot в прерывании, такты ядра (~20 мкс на 72 MHz, 2 байта ~3.6 мкс)
+
+//Статистика (команда "pwm")
+struct PWM_Sync_Stats {
+	uint16_t Phase; //Фаза последнего запуска, такты TIM3
+	uint16_t Late_max; //Наибольшее опоздание запуска от совпадения, такты TIM3
+	uint32_t Triggers; //Запусков
+	uint32_t Faults; //Выборок с ошибкой датчика
+	uint32_t SPI_errors; //Таймаутов SPI при запуске (запуск переносится на следующий период)
+};
+
+#if defined (USE_PWM_SYNC)
+
+extern struct PWM_Sync_Stats PWM_Sync_Stats;
+
+void PWM_Sync_init(uint8_t num_wires, uint16_t Phase); //1-shot в MAX31865 (SPI1), TIM3 CH2, первый запуск. После Heater_Control_init()
+void PWM_Sync_Set_Phase(uint16_t Phase); //Фаза (такты TIM3 или PWM_SYNC_PHASE_OFF_MIDDLE), со следующего запуска
+bool PWM_Sync_Take_Sample(struct Reading* Reading); //Готовая выборка (Code, Status, Timestamp). false - преобразование идет
+void TIM3_IRQHandler(void); //Сравнение CH2: запуск 1-shot
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PWM_SYNC_H */
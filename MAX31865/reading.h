@@ -0,0 +1,59 @@
+/**
+ ******************************************************************************
+ *  @file reading.h
+ *  @brief Публикация измерений по каналам без разрывов (seqlock с двумя копиями)
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Раньше результат лежал в отдельных глобальных переменных (сопротивление,
+ *  температура, ошибка), и прерывание могло прочитать температуру нового
+ *  измерения вместе с ошибкой старого. Теперь каждое измерение канала - одна
+ *  запись struct Reading, которая публикуется целиком.
+ *
+ *  Схема - seqlock с двумя копиями записи ("latch"):
+ *  - писатель (один на канал) увеличивает счетчик до нечетного, пишет копию 0,
+ *    увеличивает до четного, пишет копию 1. Писатель никогда не ждет;
+ *  - читатель берет счетчик, копирует запись Copy[Sequence & 1] - ту, которую
+ *    писатель сейчас НЕ трогает, - и проверяет, что счетчик не изменился.
+ *  Читатель в прерывании, вытеснившем писателя, не может увидеть смену счетчика
+ *  и получает целую запись с первой попытки (wait-free). Читатель в основном
+ *  цикле повторяет чтение, только если за время копирования прошла публикация.
+ ******************************************************************************
+ */
+
+#ifndef __READING_H
+#define __READING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "channel_table.h"
+
+//Одно измерение канала
+struct Reading {
+	uint16_t Code; //15-битный код АЦП
+	uint8_t Status; //Регистр Fault Status MAX31865 (0 - нет ошибки)
+	float Resistance; //Сопротивление с калибровкой, Ом
+	float Temperature; //Температура, °C
+	uint32_t Timestamp; //Clock_Now() (clock_manager.h) в момент окончания чтения регистров
+	uint32_t Sequence; //Номер публикации (с 1), 0 - измерений еще не было
+};
+
+//Ячейка канала: счетчик публикаций и две копии записи
+struct Reading_Slot {
+	volatile uint32_t Sequence; //Удвоенный номер публикации. Нечетный - пишется копия 0
+	struct Reading Copy[2];
+};
+
+uint32_t Reading_Publish(uint8_t Channel, const struct Reading* Reading); //Публикация (только один писатель на канал). Возвращает номер публикации
+bool Reading_Get(uint8_t Channel, struct Reading* Reading); //Снимок последнего измерения. false - измерений еще не было
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __READING_H */
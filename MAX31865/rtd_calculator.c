@@ -58,6 +58,22 @@ double M_D_428[4] = { 233.87, 7.9370, -2.0062, -0.3953 };
 //Коэффициенты из ГОСТ 6651-2009(Никелевые ТС и ЧЭ, 0,00617°С^-1)
 double N_D_617[3] = { 144.096, -25.502, 4.4876 };
 
+/*
+ **************************************************************************************************
+ *  @breif Целая степень умножениями
+ *  @attention Вместо pow() из libm: быстрее на МК без FPU, и результат зависит только от
+ *  IEEE-умножения, а не от реализации libm - расчеты на ПК (host/) совпадают с МК до бита.
+ *  pow() с постоянным основанием остается - его сворачивает компилятор.
+ **************************************************************************************************
+ */
+static inline double Rtd_Pow(double Value, uint8_t Power) {
+	double Result = Value;
+	while (--Power) {
+		Result *= Value;
+	}
+	return Result;
+}
+
 /*
  **************************************************************************************************
  *  @breif Функция для расчета температуры по сопротивлению термопреобразователей сопротивления
@@ -68,14 +84,14 @@ double N_D_617[3] = { 144.096, -25.502, 4.4876 };
  *  @retval Возвращает преобразованную температуру ТС
  **************************************************************************************************
  */
-double Get_Temperature_PT(double Resistance, double R0, uint8_t Type) {
+RAMFUNC double Get_Temperature_PT(double Resistance, double R0, uint8_t Type) {
 	double Temperature = 0;
 	if (Resistance < R0) {
 		for (uint8_t i = 1; i <= 4; i++) {
 			if (Type == PT_385) {
-				Temperature += (PT_D_385[i - 1] * pow((Resistance / R0 - 1), i));
+				Temperature += (PT_D_385[i - 1] * Rtd_Pow((Resistance / R0 - 1), i));
 			} else if (Type == PT_391) {
-				Temperature += (PT_D_391[i - 1] * pow((Resistance / R0 - 1), i));
+				Temperature += (PT_D_391[i - 1] * Rtd_Pow((Resistance / R0 - 1), i));
 			}
 		}
 	} else {
@@ -102,15 +118,15 @@ double Get_Resistance_PT(double Temperature, double R0, uint8_t Type) {
 	double Resistance = 0;
 	if (Temperature < 0) {
 		if (Type == PT_385) {
-			Resistance = R0 * (1 + PT_A_385 * Temperature + PT_B_385 * pow(Temperature, 2) + PT_C_385 * (Temperature - 100) * pow(Temperature, 3));
+			Resistance = R0 * (1 + PT_A_385 * Temperature + PT_B_385 * Rtd_Pow(Temperature, 2) + PT_C_385 * (Temperature - 100) * Rtd_Pow(Temperature, 3));
 		} else if (Type == PT_391) {
-			Resistance = R0 * (1 + PT_A_391 * Temperature + PT_B_391 * pow(Temperature, 2) + PT_C_391 * (Temperature - 100) * pow(Temperature, 3));
+			Resistance = R0 * (1 + PT_A_391 * Temperature + PT_B_391 * Rtd_Pow(Temperature, 2) + PT_C_391 * (Temperature - 100) * Rtd_Pow(Temperature, 3));
 		}
 	} else {
 		if (Type == PT_385) {
-			Resistance = R0 * (1 + PT_A_385 * Temperature + PT_B_385 * pow(Temperature, 2));
+			Resistance = R0 * (1 + PT_A_385 * Temperature + PT_B_385 * Rtd_Pow(Temperature, 2));
 		} else if (Type == PT_391) {
-			Resistance = R0 * (1 + PT_A_391 * Temperature + PT_B_391 * pow(Temperature, 2));
+			Resistance = R0 * (1 + PT_A_391 * Temperature + PT_B_391 * Rtd_Pow(Temperature, 2));
 		}
 	}
 	return Resistance;
@@ -131,7 +147,7 @@ double Get_Temperature_M(double Resistance, double R0, uint8_t Type) {
 	if (Resistance < R0) {
 		for (uint8_t i = 1; i <= 4; i++) {
 			if (Type == M_428) {
-				Temperature += (M_D_428[i - 1] * pow((Resistance / R0 - 1), i));
+				Temperature += (M_D_428[i - 1] * Rtd_Pow((Resistance / R0 - 1), i));
 			}
 		}
 	} else {
@@ -156,7 +172,7 @@ double Get_Resistance_M(double Temperature, double R0, uint8_t Type) {
 	double Resistance = 0;
 	if (Temperature < 0) {
 		if (Type == M_428) {
-			Resistance = R0 * (1 + M_A_428 * Temperature + M_B_428 * Temperature * (Temperature + 6.7) + M_C_428 * pow(Temperature, 3));
+			Resistance = R0 * (1 + M_A_428 * Temperature + M_B_428 * Temperature * (Temperature + 6.7) + M_C_428 * Rtd_Pow(Temperature, 3));
 		}
 	} else {
 		if (Type == M_428) {
@@ -191,7 +207,7 @@ double Get_Temperature_N(double Resistance, double R0, uint8_t Type) {
 			Temperature = (sqrt((pow(N_A_617, 2) - 4 * N_B_617 * (1 - Resistance / R0))) - N_A_617 ) / (2 * N_B_617 );
 		} else {
 			for (uint8_t i = 1; i <= 3; i++) {
-				Temperature += (N_D_617[i - 1] * pow((Resistance / R0 - 1.6172), i));
+				Temperature += (N_D_617[i - 1] * Rtd_Pow((Resistance / R0 - 1.6172), i));
 			}
 			Temperature += 100;
 		}
@@ -213,10 +229,60 @@ double Get_Resistance_N(double Temperature, double R0, uint8_t Type) {
 	double Resistance = 0;
 	if (Type == N_617) {
 		if (Temperature < 100) {
-			Resistance = R0 * (1 + N_A_617 * Temperature + N_B_617 * pow(Temperature, 2));
+			Resistance = R0 * (1 + N_A_617 * Temperature + N_B_617 * Rtd_Pow(Temperature, 2));
 		} else {
-			Resistance = R0 * (1 + N_A_617 * Temperature + N_B_617 * pow(Temperature, 2) + N_C_617 * (Temperature - 100) * pow(Temperature, 2));
+			Resistance = R0 * (1 + N_A_617 * Temperature + N_B_617 * Rtd_Pow(Temperature, 2) + N_C_617 * (Temperature - 100) * Rtd_Pow(Temperature, 2));
 		}
 	}
 	return Resistance;
 }
+
+/*
+ **************************************************************************************************
+ *  @breif Пакетные варианты функций калькулятора
+ *  @attention Буферы выделяет вызывающая сторона, функции ничего не копируют и не выделяют память.
+ *  Каждая точка считается той же функцией, что и в прошивке, поэтому результат на ПК
+ *  (см. host/python) совпадает с результатом на МК.
+ *  Входной и выходной буфер могут совпадать (пересчет "на месте").
+ *  @param  Resistance/Temperature - входной буфер
+ *  @param  Temperature/Resistance - выходной буфер
+ *  @param  Size - количество точек
+ *  @param  R0 - сопротивление ТС при 0°C
+ *  @param  Type - тип ТС (PT_385, PT_391, M_428, N_617)
+ **************************************************************************************************
+ */
+void Get_Temperature_PT_Buffer(const double* Resistance, double* Temperature, uint32_t Size, double R0, uint8_t Type) {
+	for (uint32_t i = 0; i < Size; i++) {
+		Temperature[i] = Get_Temperature_PT(Resistance[i], R0, Type);
+	}
+}
+
+void Get_Resistance_PT_Buffer(const double* Temperature, double* Resistance, uint32_t Size, double R0, uint8_t Type) {
+	for (uint32_t i = 0; i < Size; i++) {
+		Resistance[i] = Get_Resistance_PT(Temperature[i], R0, Type);
+	}
+}
+
+void Get_Temperature_M_Buffer(const double* Resistance, double* Temperature, uint32_t Size, double R0, uint8_t Type) {
+	for (uint32_t i = 0; i < Size; i++) {
+		Temperature[i] = Get_Temperature_M(Resistance[i], R0, Type);
+	}
+}
+
+void Get_Resistance_M_Buffer(const double* Temperature, double* Resistance, uint32_t Size, double R0, uint8_t Type) {
+	for (uint32_t i = 0; i < Size; i++) {
+		Resistance[i] = Get_Resistance_M(Temperature[i], R0, Type);
+	}
+}
+
+void Get_Temperature_N_Buffer(const double* Resistance, double* Temperature, uint32_t Size, double R0, uint8_t Type) {
+	for (uint32_t i = 0; i < Size; i++) {
+		Temperature[i] = Get_Temperature_N(Resistance[i], R0, Type);
+	}
+}
+
+void Get_Resistance_N_Buffer(const double* Temperature, double* Resistance, uint32_t Size, double R0, uint8_t Type) {
+	for (uint32_t i = 0; i < Size; i++) {
+		Resistance[i] = Get_Resistance_N(Temperature[i], R0, Type);
+	}
+}
@@ -43,8 +43,17 @@
  *  https://github.com/Solderingironspb/CRC-Calculator-by-Solderingiron/tree/main
  ******************************************************************************
  */
+
+#ifndef __RTD_CALCULATOR_H
+#define __RTD_CALCULATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #include <stdint.h>
 #include <math.h>
+#include "ramfunc.h"
 
 enum {
 	PT_385, //Платина
@@ -87,7 +96,7 @@ enum {
 /*-----------Коэффициенты из ГОСТ 6651-2009(Никелевые ТС и ЧЭ, 0,00617°С^-1)---------*/
 
 //Функция для расчета температуры по сопротивлению термопреобразователей сопротивления (Платиновые ТС и ЧЭ)
-double Get_Temperature_PT(double Resistance, double R0, uint8_t Type);
+RAMFUNC double Get_Temperature_PT(double Resistance, double R0, uint8_t Type);
 
 //Функция для расчета сопротивления по температуре термопреобразователей сопротивления (Платиновые ТС и ЧЭ)
 double Get_Resistance_PT(double Temperature, double R0, uint8_t Type);
@@ -104,3 +113,28 @@ double Get_Temperature_N(double Resistance, double R0, uint8_t Type);
 //Функция для расчета сопротивления по температуре термопреобразователей сопротивления (Никелевые ТС и ЧЭ)
 double Get_Resistance_N(double Temperature, double R0, uint8_t Type);
 
+/*---------------Пакетная обработка (буферы выделяет вызывающая сторона, см. host/python)---------------*/
+//Пересчет массива сопротивлений в массив температур (Платиновые ТС и ЧЭ)
+void Get_Temperature_PT_Buffer(const double* Resistance, double* Temperature, uint32_t Size, double R0, uint8_t Type);
+
+//Пересчет массива температур в массив сопротивлений (Платиновые ТС и ЧЭ)
+void Get_Resistance_PT_Buffer(const double* Temperature, double* Resistance, uint32_t Size, double R0, uint8_t Type);
+
+//Пересчет массива сопротивлений в массив температур (Медные ТС и ЧЭ)
+void Get_Temperature_M_Buffer(const double* Resistance, double* Temperature, uint32_t Size, double R0, uint8_t Type);
+
+//Пересчет массива температур в массив сопротивлений (Медные ТС и ЧЭ)
+void Get_Resistance_M_Buffer(const double* Temperature, double* Resistance, uint32_t Size, double R0, uint8_t Type);
+
+//Пересчет массива сопротивлений в массив температур (Никелевые ТС и ЧЭ)
+void Get_Temperature_N_Buffer(const double* Resistance, double* Temperature, uint32_t Size, double R0, uint8_t Type);
+
+//Пересчет массива температур в массив сопротивлений (Никелевые ТС и ЧЭ)
+void Get_Resistance_N_Buffer(const double* Temperature, double* Resistance, uint32_t Size, double R0, uint8_t Type);
+/*---------------Пакетная обработка (буферы выделяет вызывающая сторона, см. host/python)---------------*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RTD_CALCULATOR_H */
@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ *  @file sample_ring.c
+ *  @brief Кольцевой буфер измерений "один писатель - один читатель" без блокировок
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. sample_ring.h. Собирается и на ПК.
+ ******************************************************************************
+ */
+
+#include "sample_ring.h"
+
+#if defined (STM32F103xB)
+#include <stm32f1xx.h>
+#define SAMPLE_RING_LOAD(Index) ((Index))
+#define SAMPLE_RING_STORE(Index, Value) ((Index) = (Value))
+#define SAMPLE_RING_BARRIER() __DMB()
+#else
+#define SAMPLE_RING_LOAD(Index) __atomic_load_n(&(Index), __ATOMIC_ACQUIRE)
+#define SAMPLE_RING_STORE(Index, Value) __atomic_store_n(&(Index), (Value), __ATOMIC_RELEASE)
+#define SAMPLE_RING_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#define SAMPLE_RING_MASK (SAMPLE_RING_SIZE - 1)
+
+/*
+ **************************************************************************************************
+ *  @breif Пустое кольцо
+ *  @attention Звать до того, как писатель (прерывание) начнет писать.
+ **************************************************************************************************
+ */
+void Sample_Ring_Init(struct Sample_Ring* Ring) {
+	Ring->Head = 0;
+	Ring->Tail = 0;
+	Ring->High_water = 0;
+	Ring->Overflows = 0;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запись измерения (только писатель)
+ *  @param  *Ring - кольцо
+ *  @param  Channel - номер канала
+ *  @param  *Reading - измерение (копируется)
+ *  @retval false - кольцо полно, запись отброшена (Overflows)
+ **************************************************************************************************
+ */
+bool Sample_Ring_Push(struct Sample_Ring* Ring, uint8_t Channel, const struct Reading* Reading) {
+	uint32_t Head = Ring->Head; //Свой индекс - без барьера
+	uint32_t Tail = SAMPLE_RING_LOAD(Ring->Tail);
+	uint32_t Used = Head - Tail;
+
+	if (Used >= SAMPLE_RING_SIZE) {
+		Ring->Overflows++;
+		return false;
+	}
+	SAMPLE_RING_BARRIER(); //Ячейка освобождена читателем до того, как мы в нее пишем
+	struct Sample_Ring_Record* Record = &Ring->Buffer[Head & SAMPLE_RING_MASK];
+	Record->Reading = *Reading;
+	Record->Channel = Channel;
+	SAMPLE_RING_BARRIER(); //Запись видна до нового Head
+	SAMPLE_RING_STORE(Ring->Head, Head + 1);
+
+	if (Used + 1 > Ring->High_water) {
+		Ring->High_water = Used + 1;
+	}
+	return true;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Чтение самого старого измерения (только читатель)
+ *  @param  *Ring - кольцо
+ *  @param  *Channel - сюда номер канала
+ *  @param  *Reading - сюда измерение
+ *  @retval false - кольцо пусто
+ **************************************************************************************************
+ */
+bool Sample_Ring_Pop(struct Sample_Ring* Ring, uint8_t* Channel, struct Reading* Reading) {
+	uint32_t Tail = Ring->Tail; //Свой индекс - без барьера
+	uint32_t Head = SAMPLE_RING_LOAD(Ring->Head);
+
+	if (Head == Tail) {
+		return false;
+	}
+	SAMPLE_RING_BARRIER(); //Запись читается после того, как увидели Head
+	const struct Sample_Ring_Record* Record = &Ring->Buffer[Tail & SAMPLE_RING_MASK];
+	*Reading = Record->Reading;
+	*Channel = Record->Channel;
+	SAMPLE_RING_BARRIER(); //Запись прочитана до того, как ячейка отдана писателю
+	SAMPLE_RING_STORE(Ring->Tail, Tail + 1);
+	return true;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Занятость кольца
+ *  @attention Из третьего контекста (телеметрия) - только оценка: индексы могут двигаться.
+ **************************************************************************************************
+ */
+uint32_t Sample_Ring_Count(const struct Sample_Ring* Ring) {
+	uint32_t Tail = Ring->Tail;
+	uint32_t Head = Ring->Head;
+	return Head - Tail;
+}
@@ -0,0 +1,166 @@
+/**
+ ******************************************************************************
+ *  @file soft_spi.c
+ *  @brief Программный SPI на любых ножках одного порта: таймер + DMA, без участия CPU на каждый бит
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. soft_spi.h
+ ******************************************************************************
+ */
+
+#include "soft_spi.h"
+#include <stddef.h>
+
+extern volatile uint32_t Timeout_counter_ms; //Таймаут функций (см. stm32f103xx_CMSIS.c)
+
+static uint32_t Soft_SPI_Pattern[SOFT_SPI_MAX_BYTES * 16]; //Слова для BSRR: 2 на бит
+static uint16_t Soft_SPI_Samples[SOFT_SPI_MAX_BYTES * 16 + 1]; //Отсчеты IDR: 2 на бит + 1
+
+/*
+ **************************************************************************************************
+ *  @breif Настройка ножки: режим и конфигурация (4 бита CRL/CRH)
+ **************************************************************************************************
+ */
+static void Soft_SPI_Pin_Mode(GPIO_TypeDef* Port, uint8_t Pin, uint32_t Mode_cnf) {
+	volatile uint32_t* CR = (Pin < 8) ? &Port->CRL : &Port->CRH;
+	uint32_t Shift = (Pin % 8) * 4;
+	MODIFY_REG(*CR, 0xFUL << Shift, Mode_cnf << Shift);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Настройка ножек шины и таймера
+ *  @param  *Bus - ножки шины
+ **************************************************************************************************
+ */
+void Soft_SPI_init(const struct Soft_SPI* Bus) {
+	Bus->Port->BSRR = (1UL << Bus->SCK); //SCK в покое высокий (CPOL = 1)
+	Soft_SPI_Pin_Mode(Bus->Port, Bus->SCK, 0b0011); //Выход Push-Pull 50 MHz
+	Soft_SPI_Pin_Mode(Bus->Port, Bus->MOSI, 0b0011); //Выход Push-Pull 50 MHz
+	Soft_SPI_Pin_Mode(Bus->Port, Bus->MISO, 0b1000); //Вход с подтяжкой
+	Bus->Port->BSRR = (1UL << Bus->MISO); //Подтяжка к питанию
+
+	SET_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM2EN); //Тактирование TIM2
+	SET_BIT(RCC->AHBENR, RCC_AHBENR_DMA1EN); //Тактирование DMA1
+	TIM2->PSC = 0;
+	CLEAR_BIT(TIM2->CR1, TIM_CR1_CEN);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Такт TIM2 по текущим настройкам RCC (частота ядра меняется, см. clock_manager.h)
+ *  @attention Таймеры APB1 тактируются от PCLK1, а при делителе APB1 больше 1 - от 2 * PCLK1.
+ **************************************************************************************************
+ */
+static uint32_t Soft_SPI_TIM_Clock(void) {
+	SystemCoreClockUpdate(); //HCLK из RCC->CFGR
+	uint32_t Shift = APBPrescTable[READ_BIT(RCC->CFGR, RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+	return Shift ? (SystemCoreClock >> Shift) * 2 : SystemCoreClock;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Передача и прием одновременно
+ *  @param  *Bus - шина
+ *  @param  *tx_data - что передаем (NULL - нули)
+ *  @param  *rx_data - куда принимаем (NULL - не нужно)
+ *  @param  Size_data - сколько байт (до SOFT_SPI_MAX_BYTES)
+ *  @retval  Возвращает статус. True - Успешно. False - Ошибка (длина или таймаут DMA).
+ **************************************************************************************************
+ */
+bool Soft_SPI_Transfer(const struct Soft_SPI* Bus, const uint8_t* tx_data, uint8_t* rx_data, uint16_t Size_data, uint32_t Timeout_ms) {
+	uint32_t SCK_mask = 1UL << Bus->SCK;
+	uint32_t MOSI_mask = 1UL << Bus->MOSI;
+	uint32_t Words = (uint32_t) Size_data * 16;
+
+	if (Size_data == 0 || Size_data > SOFT_SPI_MAX_BYTES) {
+		return false;
+	}
+
+	//Таблица BSRR: спад SCK + бит MOSI, затем фронт SCK
+	for (uint32_t i = 0; i < Size_data; i++) {
+		uint8_t Byte = tx_data ? tx_data[i] : 0x00;
+		for (uint32_t b = 0; b < 8; b++) {
+			uint32_t Bit = (Byte << b) & 0x80;
+			Soft_SPI_Pattern[i * 16 + b * 2] = (SCK_mask << 16) | (Bit ? MOSI_mask : (MOSI_mask << 16));
+			Soft_SPI_Pattern[i * 16 + b * 2 + 1] = SCK_mask;
+		}
+	}
+
+	//Полбита под текущую частоту
+	uint32_t Half = Soft_SPI_TIM_Clock() / (2 * SOFT_SPI_HZ);
+	TIM2->ARR = (Half < SOFT_SPI_HALF_MIN ? SOFT_SPI_HALF_MIN : Half) - 1;
+	TIM2->CCR1 = (TIM2->ARR + 1) / 2; //Чтение MISO в середине полупериода
+
+	//DMA1 Channel2: TIM2_UP, память -> BSRR, 32 бита
+	DMA1_Channel2->CCR = 0;
+	DMA1_Channel2->CPAR = (uint32_t) &Bus->Port->BSRR;
+	DMA1_Channel2->CMAR = (uint32_t) Soft_SPI_Pattern;
+	DMA1_Channel2->CNDTR = Words;
+	DMA1_Channel2->CCR = DMA_CCR_DIR | DMA_CCR_MINC | (0b10 << DMA_CCR_PSIZE_Pos) | (0b10 << DMA_CCR_MSIZE_Pos) | (0b11 << DMA_CCR_PL_Pos);
+
+	//DMA1 Channel5: TIM2_CH1, IDR -> память, 16 бит
+	DMA1_Channel5->CCR = 0;
+	DMA1_Channel5->CPAR = (uint32_t) &Bus->Port->IDR;
+	DMA1_Channel5->CMAR = (uint32_t) Soft_SPI_Samples;
+	DMA1_Channel5->CNDTR = Words + 1;
+	DMA1_Channel5->CCR = DMA_CCR_MINC | (0b01 << DMA_CCR_PSIZE_Pos) | (0b01 << DMA_CCR_MSIZE_Pos) | (0b11 << DMA_CCR_PL_Pos);
+
+	SET_BIT(DMA1->IFCR, DMA_IFCR_CGIF2 | DMA_IFCR_CGIF5);
+	SET_BIT(DMA1_Channel2->CCR, DMA_CCR_EN);
+	SET_BIT(DMA1_Channel5->CCR, DMA_CCR_EN);
+
+	TIM2->CNT = 0;
+	TIM2->SR = 0;
+	TIM2->DIER = TIM_DIER_UDE | TIM_DIER_CC1DE; //Запросы DMA по переполнению и сравнению
+	SET_BIT(TIM2->CR1, TIM_CR1_CEN);
+
+	bool Status = true;
+	Timeout_counter_ms = Timeout_ms;
+	while (!READ_BIT(DMA1->ISR, DMA_ISR_TCIF5)) {
+		//Ждем последний отсчет MISO (он после последней записи в BSRR)
+		if (!Timeout_counter_ms) {
+			Status = false;
+			break;
+		}
+	}
+
+	CLEAR_BIT(TIM2->CR1, TIM_CR1_CEN);
+	TIM2->DIER = 0;
+	CLEAR_BIT(DMA1_Channel2->CCR, DMA_CCR_EN);
+	CLEAR_BIT(DMA1_Channel5->CCR, DMA_CCR_EN);
+	SET_BIT(DMA1->IFCR, DMA_IFCR_CGIF2 | DMA_IFCR_CGIF5);
+	Bus->Port->BSRR = SCK_mask; //SCK в покое
+
+	if (Status && rx_data) {
+		uint16_t MISO_mask = (uint16_t) (1U << Bus->MISO);
+		for (uint32_t i = 0; i < Size_data; i++) {
+			uint8_t Byte = 0;
+			for (uint32_t b = 0; b < 8; b++) {
+				Byte = (uint8_t) ((Byte << 1) | ((Soft_SPI_Samples[i * 16 + b * 2 + 2] & MISO_mask) ? 1 : 0));
+			}
+			rx_data[i] = Byte;
+		}
+	}
+	return Status;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Передача данных (MISO не читается)
+ **************************************************************************************************
+ */
+bool Soft_SPI_Data_Transmit_8BIT(const struct Soft_SPI* Bus, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms) {
+	return Soft_SPI_Transfer(Bus, data, NULL, Size_data, Timeout_ms);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Прием данных (на MOSI нули, как в CMSIS_SPI_Data_Receive_8BIT)
+ **************************************************************************************************
+ */
+bool Soft_SPI_Data_Receive_8BIT(const struct Soft_SPI* Bus, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms) {
+	return Soft_SPI_Transfer(Bus, NULL, data, Size_data, Timeout_ms);
+}
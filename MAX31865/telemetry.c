@@ -0,0 +1,286 @@
+/**
+ ******************************************************************************
+ *  @file telemetry.c
+ *  @brief Текстовые команды телеметрии по USART1
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Список команд см. telemetry.h
+ ******************************************************************************
+ */
+
+#include "telemetry.h"
+#include "profiler.h"
+#include "mem_usage.h"
+#include "fault_log.h"
+#include "max31865_sync.h"
+#include "trip.h"
+#include "bus_sched.h"
+#include "clock_manager.h"
+#include "crc32.h"
+#include "i2c_dma.h"
+#include "pwm_sync.h"
+#include "heater_control.h"
+#include <string.h>
+
+extern struct USART_name husart1; //Буферы USART1 (см. stm32f103xx_CMSIS.c)
+
+/*
+ **************************************************************************************************
+ *  @breif Отправка строки в USART1
+ **************************************************************************************************
+ */
+void Telemetry_Send_String(const char* String) {
+	CMSIS_USART_Transmit(USART1, (uint8_t*) String, (uint16_t) strlen(String), 100);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Отправка пары " имя=значение" в USART1 (без printf)
+ **************************************************************************************************
+ */
+static void Telemetry_Send_Value(const char* Name, uint32_t Value) {
+	char Line[32];
+	char Digits[10];
+	uint8_t Length = 0;
+	uint8_t Count = 0;
+
+	Line[Length++] = ' ';
+	while (*Name && Length < sizeof(Line) - sizeof(Digits) - 1) {
+		Line[Length++] = *Name++;
+	}
+	Line[Length++] = '=';
+	do {
+		Digits[Count++] = (char) ('0' + Value % 10);
+		Value /= 10;
+	} while (Value);
+	while (Count) {
+		Line[Length++] = Digits[--Count];
+	}
+	CMSIS_USART_Transmit(USART1, (uint8_t*) Line, Length, 100);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Сравнение принятой команды со строкой
+ **************************************************************************************************
+ */
+static bool Telemetry_Command_Is(const char* Command, uint16_t Length, const char* Name) {
+	return strlen(Name) == Length && memcmp(Command, Name, Length) == 0;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Обработка принятой по USART1 команды
+ *  @attention Вызывать из основного цикла. Если команды нет - сразу выходит.
+ **************************************************************************************************
+ */
+void Telemetry_Poll(void) {
+	char Command[sizeof(husart1.rx_buffer)];
+	uint16_t Length = husart1.rx_len;
+
+	if (Length == 0) {
+		return;
+	}
+	if (Length > sizeof(Command)) {
+		Length = sizeof(Command);
+	}
+	memcpy(Command, husart1.rx_buffer, Length);
+	husart1.rx_len = 0;
+	while (Length && (Command[Length - 1] == '\r' || Command[Length - 1] == '\n')) {
+		Length--;
+	}
+
+	if (Telemetry_Command_Is(Command, Length, "prof")) {
+#if defined (USE_PROFILER)
+		Profiler_Dump(USART1);
+#else
+		Telemetry_Send_String("profiler disabled (USE_PROFILER)\r\n");
+#endif
+	} else if (Telemetry_Command_Is(Command, Length, "prof reset")) {
+#if defined (USE_PROFILER)
+		Profiler_Reset();
+#endif
+		Telemetry_Send_String("ok\r\n");
+	} else if (Telemetry_Command_Is(Command, Length, "mem")) {
+		struct Mem_Usage Usage;
+		Mem_Usage_Get(&Usage);
+		Telemetry_Send_String("mem");
+		Telemetry_Send_Value("static", Usage.Static);
+		Telemetry_Send_Value("heap", Usage.Heap);
+		Telemetry_Send_Value("heap_peak", Usage.Heap_peak);
+		Telemetry_Send_Value("heap_fail", Usage.Heap_failures);
+		Telemetry_Send_Value("stack_reserved", Usage.Stack_reserved);
+		Telemetry_Send_Value("stack_peak", Usage.Stack_peak);
+		Telemetry_Send_Value("free_min", Usage.Free_min);
+		Telemetry_Send_Value("channels", CHANNEL_COUNT);
+		Telemetry_Send_Value("per_channel", Channel_Table_Bytes_Per_Channel());
+		Telemetry_Send_String("\r\n");
+	} else if (Telemetry_Command_Is(Command, Length, "spi")) {
+		Telemetry_Send_String("spi");
+		Telemetry_Send_Value("br", MAX31865_SPI_Link.Prescaler);
+		Telemetry_Send_Value("hz", MAX31865_SPI_Link.Frequency);
+		Telemetry_Send_Value("failed_br", MAX31865_SPI_Link.Failed_prescaler);
+		Telemetry_Send_Value("errors", MAX31865_SPI_Link.Errors);
+		Telemetry_Send_String("\r\n");
+	} else if (Telemetry_Command_Is(Command, Length, "sync")) {
+		Telemetry_Send_String("sync");
+		Telemetry_Send_Value("valid", MAX31865_Sync_Last.Valid);
+		Telemetry_Send_Value("skew_cycles", MAX31865_Sync_Last.Skew_cycles);
+		Telemetry_Send_Value("skew_ns", (uint32_t) ((uint64_t) MAX31865_Sync_Last.Skew_cycles * 1000 / CLOCK_NOW_PER_US));
+		for (uint32_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+			Telemetry_Send_Value("code", MAX31865_Sync_Last.Code[Channel]);
+			Telemetry_Send_Value("offset", MAX31865_Sync_Last.Trigger_offset[Channel]);
+			Telemetry_Send_Value("trig", MAX31865_Sync_Last.Triggered[Channel]);
+		}
+		Telemetry_Send_String("\r\n");
+	} else if (Telemetry_Command_Is(Command, Length, "sched")) {
+		Telemetry_Send_String("sched");
+		Telemetry_Send_Value("load_permille", Bus_Sched_Load_permille());
+		Telemetry_Send_Value("overload", Bus_Sched_Overload);
+		Telemetry_Send_String("\r\n");
+		for (uint32_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+			const struct Bus_Sched_Channel* C = &Bus_Sched_Table[Channel];
+			if (!C->Admitted) {
+				continue;
+			}
+			Telemetry_Send_String("sched");
+			Telemetry_Send_Value("ch", Channel);
+			Telemetry_Send_Value("period_ms", C->Period_ms);
+			Telemetry_Send_Value("one_shot", C->One_shot);
+			Telemetry_Send_Value("jobs", C->Jobs);
+			Telemetry_Send_Value("misses", C->Misses);
+			Telemetry_Send_Value("skipped", C->Skipped);
+			Telemetry_Send_Value("late_max", C->Lateness_max);
+			Telemetry_Send_Value("cost_trig", C->Cost_trigger);
+			Telemetry_Send_Value("cost_read", C->Cost_read);
+			Telemetry_Send_String("\r\n");
+		}
+	} else if (Telemetry_Command_Is(Command, Length, "crc")) {
+		struct CRC32_Bench Bench;
+		CRC32_Bench_Run(&Bench);
+		Telemetry_Send_String("crc");
+		Telemetry_Send_Value("bytes", CRC32_BENCH_SIZE);
+		Telemetry_Send_Value("soft", Bench.Soft_cycles);
+		Telemetry_Send_Value("hard", Bench.Hard_cycles);
+		Telemetry_Send_Value("dma", Bench.DMA_cycles);
+		Telemetry_Send_Value("match", Bench.Match);
+		Telemetry_Send_String("\r\n");
+#if defined (USE_I2C_DMA)
+	} else if (Telemetry_Command_Is(Command, Length, "i2c")) {
+		Telemetry_Send_String("i2c");
+		Telemetry_Send_Value("done", I2C_DMA_Stats.Done);
+		Telemetry_Send_Value("nack", I2C_DMA_Stats.Nacks);
+		Telemetry_Send_Value("errors", I2C_DMA_Stats.Errors);
+		Telemetry_Send_Value("timeouts", I2C_DMA_Stats.Timeouts);
+		Telemetry_Send_Value("rejected", I2C_DMA_Stats.Rejected);
+		Telemetry_Send_Value("queue_max", I2C_DMA_Stats.Queue_max);
+		Telemetry_Send_String("\r\n");
+#endif
+#if defined (USE_CLOCK_SCALING)
+	} else if (Telemetry_Command_Is(Command, Length, "clock")) {
+		uint32_t Samples = 0;
+		for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+			struct Reading Reading;
+			if (Reading_Get(Channel, &Reading)) {
+				Samples += Reading.Sequence;
+			}
+		}
+		uint32_t Energy = Clock_Energy_uJ();
+		Telemetry_Send_String("clock");
+		Telemetry_Send_Value("t8_ms", Clock_Stats.Time_ms[CLOCK_HSE_8MHZ]);
+		Telemetry_Send_Value("t72_ms", Clock_Stats.Time_ms[CLOCK_PLL_72MHZ]);
+		Telemetry_Send_Value("switches", Clock_Stats.Switches);
+		Telemetry_Send_Value("up_us", Clock_Stats.Up_us_max);
+		Telemetry_Send_Value("down_us", Clock_Stats.Down_us_max);
+		Telemetry_Send_Value("energy_uj", Energy);
+		Telemetry_Send_Value("uj_per_sample", Samples ? Energy / Samples : 0);
+		Telemetry_Send_String("\r\n");
+#endif
+#if defined (USE_PWM_SYNC)
+	} else if (Telemetry_Command_Is(Command, Length, "pwm")) {
+		Telemetry_Send_String("pwm");
+		Telemetry_Send_Value("phase", PWM_Sync_Stats.Phase);
+		Telemetry_Send_Value("period", HEATER_PWM_PERIOD);
+		Telemetry_Send_Value("triggers", PWM_Sync_Stats.Triggers);
+		Telemetry_Send_Value("late_max", PWM_Sync_Stats.Late_max);
+		Telemetry_Send_Value("faults", PWM_Sync_Stats.Faults);
+		Telemetry_Send_Value("spi_err", PWM_Sync_Stats.SPI_errors);
+		Telemetry_Send_String("\r\n");
+#endif
+#if defined (USE_TRIP)
+	} else if (Telemetry_Command_Is(Command, Length, "trip")) {
+		for (uint32_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+			Telemetry_Send_String("trip");
+			Telemetry_Send_Value("ch", Channel);
+			Telemetry_Send_Value("active", Trip_Table[Channel].Tripped);
+			Telemetry_Send_Value("count", Trip_Table[Channel].Trip_count);
+			Telemetry_Send_Value("low", Trip_Table[Channel].Low_code);
+			Telemetry_Send_Value("high", Trip_Table[Channel].High_code);
+			Telemetry_Send_Value("hyst", Trip_Table[Channel].Hysteresis);
+			Telemetry_Send_Value("latency_max", Trip_Latency_max_cycles);
+			Telemetry_Send_Value("spi_err", Trip_SPI_errors);
+			Telemetry_Send_Value("ring_hw", Trip_Samples.High_water);
+			Telemetry_Send_Value("ring_lost", Trip_Samples.Overflows);
+			Telemetry_Send_String("\r\n");
+		}
+	} else if (Telemetry_Command_Is(Command, Length, "trip reset")) {
+		for (uint32_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+			Trip_Reset(Channel);
+		}
+		Telemetry_Send_String("ok\r\n");
+#endif
+	} else if (Telemetry_Command_Is(Command, Length, "heater")) {
+		Telemetry_Send_String("heater");
+		Telemetry_Send_Value("duty", TIM3->CCR1);
+		Telemetry_Send_Value("auto", Heater_PID.Automatic);
+		Telemetry_Send_Value("fault", Heater_Sensor_fault);
+		Telemetry_Send_Value("latency", Heater_Latency_cycles);
+		Telemetry_Send_Value("latency_max", Heater_Latency_max_cycles);
+		Telemetry_Send_String("\r\n");
+	} else if (Telemetry_Command_Is(Command, Length, "trend")) {
+		for (uint32_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+			Telemetry_Send_String("trend");
+			Telemetry_Send_Value("ch", Channel);
+			Telemetry_Send_Value("pre", Trend_Table[Channel].Pre_alarm);
+			Telemetry_Send_Value("count", Trend_Table[Channel].Pre_alarm_count);
+			Telemetry_Send_Value("ttl_s", Trend_Table[Channel].Time_to_limit_ms / 1000);
+			Telemetry_Send_Value("points", Trend_Table[Channel].Points);
+			Telemetry_Send_Value("low", Trend_Table[Channel].Low_code);
+			Telemetry_Send_Value("high", Trend_Table[Channel].High_code);
+			Telemetry_Send_String("\r\n");
+		}
+	} else if (Telemetry_Command_Is(Command, Length, "fault")) {
+		for (uint32_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+			Telemetry_Send_String("fault");
+			Telemetry_Send_Value("ch", Channel);
+			for (uint32_t i = 0; i < MAX31865_FAULT_COUNT; i++) {
+				Telemetry_Send_Value(Fault_Log_Name(i), Fault_Log.Counters[i][Channel]);
+			}
+			Telemetry_Send_String("\r\n");
+		}
+		uint32_t Total = Fault_Log.Total;
+		uint32_t First = Total > FAULT_LOG_SIZE ? Total - FAULT_LOG_SIZE : 0;
+		for (uint32_t n = First; n < Total; n++) {
+			const struct Fault_Event* Event = &Fault_Log.Events[n % FAULT_LOG_SIZE];
+			Telemetry_Send_String("event");
+			Telemetry_Send_Value("n", n);
+			Telemetry_Send_Value("t_ms", Event->Time_ms);
+			Telemetry_Send_Value("ch", Event->Channel);
+			Telemetry_Send_Value("status", Event->Status);
+			for (uint32_t i = 0; i < MAX31865_FAULT_COUNT; i++) {
+				if (Event->Status & MAX31865_FAULT_MASK(i)) {
+					Telemetry_Send_String(" ");
+					Telemetry_Send_String(Fault_Log_Name(i));
+				}
+			}
+			Telemetry_Send_String("\r\n");
+		}
+	} else if (Telemetry_Command_Is(Command, Length, "fault reset")) {
+		Fault_Log_Reset();
+		Telemetry_Send_String("ok\r\n");
+	} else {
+		Telemetry_Send_String("unknown command\r\n");
+	}
+}
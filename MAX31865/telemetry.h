@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ *  @file telemetry.h
+ *  @brief Текстовые команды телеметрии по USART1
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Команда - строка ASCII, принятая USART1 целиком (до флага IDLE, см. USART1_IRQHandler).
+ *  Символы \r и \n в конце игнорируются. Ответ уходит в тот же USART1.
+ *  Telemetry_Poll() вызывается из основного цикла; ответ передается блокирующе.
+ *
+ *  Команды:
+ *  - "prof"        - таблица профилировщика (profiler.h, нужен USE_PROFILER)
+ *  - "prof reset"  - очистка таблицы профилировщика
+ *  - "mem"         - ОЗУ в байтах: static, heap, heap_peak, heap_fail, stack_reserved,
+ *                    stack_peak, free_min (mem_usage.h), channels, per_channel (channel_table.h)
+ *  - "heater"      - нагреватель (heater_control.h): duty (CCR1, такты ШИМ), auto - регулятор
+ *                    в автомате, fault - выключен по ошибке датчика, latency и latency_max -
+ *                    задержка измерение -> ШИМ в тактах
+ *  - "trend"       - прогноз выхода за пределы по каналам (pipeline.h): pre - предварительная
+ *                    авария, count, ttl_s - до предела по прогнозу (4294967 - не приближаемся),
+ *                    points в окне, пределы low/high в кодах
+ *  - "fault"       - счетчики ошибок MAX31865 по битам для каждого канала и журнал
+ *                    последних FAULT_LOG_SIZE событий (fault_log.h)
+ *  - "fault reset" - очистка счетчиков и журнала
+ *  - "spi"         - результат подбора частоты SPI: br, hz, failed_br (255 - ошибок не было),
+ *                    errors (MAX31865_SPI_Tune())
+ *  - "sync"        - последний синхронный снимок: разброс запуска каналов в тактах и нс,
+ *                    код, смещение и trig (запуск прошел) каждого канала (max31865_sync.h)
+ *  - "sched"       - планировщик шины (bus_sched.h): загрузка в промилле, overload; по каналам
+ *                    period_ms, one_shot, jobs, misses, skipped, late_max, cost_trig,
+ *                    cost_read (такты)
+ *  - "crc"         - такты CRC-32 буфера CRC32_BENCH_SIZE байт: soft (таблица), hard (блок CRC),
+ *                    dma (блок CRC через DMA), match - результаты совпали (crc32.h)
+ *  - "i2c"         - очередь I2C1 (i2c_dma.h, нужен USE_I2C_DMA): done, nack, errors, timeouts,
+ *                    rejected (очередь полна), queue_max
+ *  - "clock"       - смена частоты (clock_manager.h, нужен USE_CLOCK_SCALING): время на 8 и
+ *                    72 MHz, switches, худшие up_us/down_us, оценка energy_uj и uj_per_sample
+ *  - "pwm"         - запуск по фазе ШИМ (pwm_sync.h, нужен USE_PWM_SYNC): phase и period в
+ *                    тактах TIM3 (мкс), triggers, late_max - опоздание запуска (мкс), faults
+ *  - "trip"        - состояние аварий по каналам: active, count, пределы в кодах,
+ *                    latency_max в тактах, ring_hw и ring_lost кольца выборок DRDY
+ *                    (trip.h, нужен USE_TRIP)
+ *  - "trip reset"  - снятие защелок аварий (если условие ушло)
+ ******************************************************************************
+ */
+
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include "stm32f103xx_CMSIS.h"
+
+void Telemetry_Poll(void); //Обработка принятой команды (если есть)
+void Telemetry_Send_String(const char* String); //Отправка строки в USART1
+
+#endif /* __TELEMETRY_H */
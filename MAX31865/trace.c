@@ -0,0 +1,34 @@
+/**
+ ******************************************************************************
+ *  @file trace.c
+ *  @brief Трассировка событий тракта измерения через ITM/SWO
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Формат событий см. trace.h. Файл пустой, пока не определен USE_TRACE.
+ ******************************************************************************
+ */
+
+#include "trace.h"
+
+#if defined (USE_TRACE)
+
+#include "stm32f103xx_CMSIS.h"
+
+volatile uint32_t Trace_Dropped = 0; //Сколько событий отброшено из-за занятого FIFO
+
+/*
+ **************************************************************************************************
+ *  @breif Запуск трассировки
+ *  @attention Вызывать после CMSIS_Debug_init() и CMSIS_RCC_SystemClock_72MHz().
+ *  PB3 после этого занята под TRACESWO.
+ **************************************************************************************************
+ */
+void Trace_Init(void) {
+	CMSIS_DWT_Cycle_Counter_init();
+	CMSIS_SWO_init(TRACE_SWO_BAUD, 1UL << TRACE_ITM_PORT);
+	Trace_Dropped = 0;
+}
+
+#endif
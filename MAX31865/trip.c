@@ -0,0 +1,217 @@
+/**
+ ******************************************************************************
+ *  @file trip.c
+ *  @brief Аварийные отключения по DRDY: пределы, гистерезис, задержка, защелка, выход GPIO
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. trip.h. Файл пустой, пока не определен USE_TRIP.
+ ******************************************************************************
+ */
+
+#include "trip.h"
+
+#if defined (USE_TRIP) && defined (USE_CMSIS)
+
+#include "trace.h"
+#include "clock_manager.h"
+
+struct Trip_Channel Trip_Table[CHANNEL_COUNT];
+volatile uint32_t Trip_Latency_max_cycles = 0;
+
+volatile uint32_t Trip_SPI_errors = 0;
+
+struct Sample_Ring Trip_Samples; //Выборки из прерывания для основного цикла
+
+//Последняя выборка каждого канала (для Trip_Reset())
+static volatile uint16_t Trip_Last_code[CHANNEL_COUNT];
+static volatile uint8_t Trip_Last_status[CHANNEL_COUNT];
+
+//Конфигурация как в MAX31865_Init() с битом сброса ошибок (D1)
+static const uint8_t Trip_Fault_clear[2] = { 0x80, TRIP_WIRES == 3 ? 0xD3 : 0xC3 };
+
+/*
+ **************************************************************************************************
+ *  @breif Выход аварии: ИЛИ по всем каналам, запись одной инструкцией в BSRR
+ **************************************************************************************************
+ */
+static inline bool Trip_Output_Update(void) {
+	bool Active = false;
+	for (uint32_t i = 0; i < CHANNEL_COUNT; i++) {
+		Active = Active || Trip_Table[i].Tripped;
+	}
+	TRIP_PORT->BSRR = Active ? (1UL << TRIP_PIN) : (1UL << (TRIP_PIN + 16));
+	return Active;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif DRDY уже опущен, а прерывание не ожидает: фронт пропущен, чтение по прерыванию
+ *  @attention Без чтения MAX31865 DRDY не поднимет, и спада больше не будет.
+ **************************************************************************************************
+ */
+static void Trip_Drdy_Kick(void) {
+	if (!READ_BIT(GPIOB->IDR, GPIO_IDR_IDR0) && !READ_BIT(EXTI->PR, EXTI_PR_PR0)) {
+		NVIC_SetPendingIRQ(EXTI0_IRQn);
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Настройка выхода аварии и прерывания DRDY
+ *  @attention DRDY MAX31865 - открытый сток, активный низкий: вход с подтяжкой, прерывание по спаду.
+ *  MAX31865 должен быть в автоматическом режиме (MAX31865_Init()).
+ **************************************************************************************************
+ */
+void Trip_init(void) {
+	Sample_Ring_Init(&Trip_Samples);
+	SET_BIT(RCC->APB2ENR, RCC_APB2ENR_IOPBEN); //Тактирование порта B
+	SET_BIT(RCC->APB2ENR, RCC_APB2ENR_AFIOEN); //Тактирование AFIO (EXTICR)
+
+	//Выход аварии: Push-Pull 50 MHz, сразу неактивный
+	TRIP_PORT->BSRR = (1UL << (TRIP_PIN + 16));
+	MODIFY_REG(GPIOB->CRH, GPIO_CRH_MODE12, 0b11 << GPIO_CRH_MODE12_Pos);
+	MODIFY_REG(GPIOB->CRH, GPIO_CRH_CNF12, 0b00 << GPIO_CRH_CNF12_Pos);
+
+	//DRDY - PB0: вход с подтяжкой к питанию
+	MODIFY_REG(GPIOB->CRL, GPIO_CRL_MODE0, 0b00 << GPIO_CRL_MODE0_Pos);
+	MODIFY_REG(GPIOB->CRL, GPIO_CRL_CNF0, 0b10 << GPIO_CRL_CNF0_Pos);
+	GPIOB->BSRR = GPIO_BSRR_BS0;
+
+	CMSIS_AFIO_EXTICR1_B0_select(); //EXTI0 <- PB0
+	SET_BIT(EXTI->FTSR, EXTI_FTSR_TR0); //По спаду
+	CLEAR_BIT(EXTI->RTSR, EXTI_RTSR_TR0);
+	SET_BIT(EXTI->PR, EXTI_PR_PR0);
+	SET_BIT(EXTI->IMR, EXTI_IMR_MR0);
+	NVIC_SetPriority(EXTI0_IRQn, 0); //Выше SysTick и USART: авария важнее
+	NVIC_EnableIRQ(EXTI0_IRQn);
+	Trip_Drdy_Kick(); //Преобразование могло закончиться до включения EXTI
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Пределы аварии в °C с переводом в коды АЦП
+ *  @attention double - вызывать при настройке, не в прерывании. Учитывает калибровку канала.
+ **************************************************************************************************
+ */
+void Trip_Set_Limits_degC(uint8_t Channel, float Low, float High, float Hysteresis) {
+	struct Trip_Channel Limits = Trip_Table[Channel];
+	Pipeline_Trip_Limits_degC(&Limits, Channel, Low, High, Hysteresis);
+
+	__disable_irq();
+	Trip_Table[Channel].Low_code = Limits.Low_code;
+	Trip_Table[Channel].High_code = Limits.High_code;
+	Trip_Table[Channel].Hysteresis = Limits.Hysteresis;
+	__enable_irq();
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Логика аварии канала на новую выборку
+ *  @attention Только целые. Вызывается из прерывания DRDY (или завершения DMA) сразу после чтения.
+ *  @param  Channel - номер канала
+ *  @param  Code - 15-битный код АЦП
+ *  @param  Status - регистр Fault Status (0 - нет ошибки)
+ *  @retval Состояние выхода аварии после шага
+ **************************************************************************************************
+ */
+bool Trip_Evaluate(uint8_t Channel, uint16_t Code, uint8_t Status) {
+	Trip_Last_code[Channel] = Code;
+	Trip_Last_status[Channel] = Status;
+	Pipeline_Trip_Step(&Trip_Table[Channel], Code, Status);
+	return Trip_Output_Update();
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Снятие защелки канала
+ *  @attention Авария снимается, только если последний код этого канала уже внутри пределов с гистерезисом.
+ **************************************************************************************************
+ */
+void Trip_Reset(uint8_t Channel) {
+	__disable_irq();
+	bool Latching = Trip_Table[Channel].Latching;
+	Trip_Table[Channel].Latching = false;
+	Trip_Evaluate(Channel, Trip_Last_code[Channel], Trip_Last_status[Channel]);
+	Trip_Table[Channel].Latching = Latching;
+	__enable_irq();
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Забрать самую старую выборку из прерывания DRDY (для публикации в основном цикле)
+ *  @attention Без запрета прерываний (sample_ring.h). Звать, пока возвращает true.
+ *  На пустом кольце проверяет DRDY: опущенный без прерывания - повторное чтение.
+ *  @param  *Reading - заполняются Code, Status, Timestamp
+ *  @retval true - есть новая выборка
+ **************************************************************************************************
+ */
+bool Trip_Take_Sample(struct Reading* Reading) {
+	uint8_t Channel;
+	bool Taken = Sample_Ring_Pop(&Trip_Samples, &Channel, Reading);
+	if (!Taken) {
+		Trip_Drdy_Kick(); //Обработчик не смог прочитать (таймаут SPI) - DRDY висит внизу
+	}
+	return Taken;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif DRDY: чтение кода, решение об аварии, запись выхода
+ *  @attention SPI - опросом регистров с пределом в тактах DWT (TRIP_SPI_TIMEOUT_CYCLES):
+ *  Timeout_counter_ms общий с основным циклом, а SysTick здесь не идет.
+ *  Чтение кода (оно поднимает DRDY) делается всегда; при таймауте выборки нет,
+ *  DRDY дочитает Trip_Take_Sample().
+ **************************************************************************************************
+ */
+void EXTI0_IRQHandler(void) {
+	uint32_t Entry = Clock_Now();
+	uint8_t Tx[3] = { 0x01, 0x00, 0x00 };
+	uint8_t Rx[3];
+	uint8_t Status = 0;
+
+	SET_BIT(EXTI->PR, EXTI_PR_PR0);
+	TRACE_EVENT(TRACE_DRDY, TRIP_DRDY_CHANNEL);
+
+	NSS_ON;
+	bool Ok = CMSIS_SPI_Data_Exchange_8BIT_cycles(SPI1, Tx, Rx, 3, TRIP_SPI_TIMEOUT_CYCLES);
+	NSS_OFF;
+	if (!Ok) {
+		Trip_SPI_errors++;
+		return;
+	}
+	uint16_t Code = (uint16_t) (((Rx[1] << 8) | Rx[2]) >> 1);
+	if (Rx[2] & 0x01) {
+		//Флаг ошибки в младшем бите кода - дочитываем Fault Status
+		Tx[0] = 0x07;
+		NSS_ON;
+		Ok = CMSIS_SPI_Data_Exchange_8BIT_cycles(SPI1, Tx, Rx, 2, TRIP_SPI_TIMEOUT_CYCLES);
+		NSS_OFF;
+		Status = Ok ? Rx[1] : 0xFF; //Статус не прочитан - все равно ошибка датчика
+		if (!Ok) {
+			Trip_SPI_errors++;
+		}
+	}
+
+	Trip_Evaluate(TRIP_DRDY_CHANNEL, Code, Status);
+	uint32_t Latency = Clock_Now() - Entry;
+	if (Latency > Trip_Latency_max_cycles) {
+		Trip_Latency_max_cycles = Latency;
+	}
+
+	if (Status) {
+		TRACE_EVENT(TRACE_FAULT, TRIP_DRDY_CHANNEL);
+		//Сброс ошибки - уже после записи выхода аварии
+		NSS_ON;
+		if (!CMSIS_SPI_Data_Exchange_8BIT_cycles(SPI1, Trip_Fault_clear, Rx, 2, TRIP_SPI_TIMEOUT_CYCLES)) {
+			Trip_SPI_errors++;
+		}
+		NSS_OFF;
+	}
+
+	struct Reading Sample = { .Code = Code, .Status = Status, .Timestamp = Entry };
+	Sample_Ring_Push(&Trip_Samples, TRIP_DRDY_CHANNEL, &Sample); //Полное кольцо - выборка в Trip_Samples.Overflows, авария уже отработана
+}
+
+#endif
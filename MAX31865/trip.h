@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ *  @file trip.h
+ *  @brief Аварийные отключения по DRDY: пределы, гистерезис, задержка, защелка, выход GPIO
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Раньше решение об аварии принималось в основном цикле: до 200 мс ожидания
+ *  плюс пересчет в double. Здесь авария решается в прерывании DRDY (EXTI0, PB0):
+ *  MAX31865 в автоматическом режиме опускает DRDY по готовности преобразования,
+ *  обработчик читает 2 байта кода (и регистр Fault Status, только если в коде
+ *  выставлен флаг ошибки), сравнивает код с пределами канала в кодах АЦП и
+ *  сразу пишет выход аварии через BSRR. Никакого double в прерывании.
+ *
+ *  Для каждого канала: верхний/нижний предел (коды), гистерезис (коды),
+ *  задержка срабатывания (столько выборок подряд за пределом), защелка
+ *  (авария держится до Trip_Reset()), авария по ошибке датчика.
+ *  Выход аварии (TRIP_PORT/TRIP_PIN, активный высокий) - ИЛИ по всем каналам.
+ *
+ *  Задержка аварии: не больше одного периода преобразования MAX31865 (20 мс
+ *  в автоматическом режиме с фильтром 50 Гц) * Delay_on, плюс обработчик:
+ *  вход в прерывание 12 тактов, 3 байта SPI при 4.5 MHz ~5.3 мкс, сравнение и
+ *  запись BSRR - всего порядка 7 мкс от спада DRDY до выхода. Фактическое время
+ *  от входа в обработчик до записи BSRR копится в Trip_Latency_max_cycles.
+ *
+ *  SPI в обработчике - опросом регистров с пределом по DWT, без Timeout_counter_ms
+ *  (он общий с основным циклом, а SysTick ниже приоритетом). Если чтение не удалось
+ *  и DRDY остался внизу, Trip_Take_Sample() вызывает обработчик повторно.
+ *
+ *  В режиме DRDY только обработчик обращается к MAX31865 по SPI1: основной цикл
+ *  берет выборки через Trip_Take_Sample() и публикует их (MAX31865_Publish()).
+ *  Выборки копятся в кольце Trip_Samples (sample_ring.h) - основной цикл, занятый
+ *  дольше периода преобразования, их не теряет, а прерывания не запрещаются.
+ ******************************************************************************
+ */
+
+#ifndef __TRIP_H
+#define __TRIP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "MAX31865.h"
+#include "sample_ring.h"
+
+/*----------Включение аварий по DRDY----------*/
+//#define USE_TRIP   //Раскомментировать: DRDY (PB0) -> прерывание, основной цикл берет выборки через Trip_Take_Sample()
+/*----------Включение аварий по DRDY----------*/
+
+#define TRIP_PORT GPIOB //Порт выхода аварии
+#define TRIP_PIN  12    //Пин выхода аварии (активный высокий)
+#define TRIP_DRDY_CHANNEL 0 //Канал, чей DRDY заведен на PB0
+#define TRIP_WIRES 3 //Схема подключения датчика (для повторной инициализации после ошибки)
+#define TRIP_SPI_TIMEOUT_CYCLES 1440 //Предел обмена SPI в обработчике, такты ядра (~20 мкс на 72 MHz, обмен 3 байт ~5.3 мкс)
+
+extern struct Trip_Channel Trip_Table[CHANNEL_COUNT]; //struct Trip_Channel - в pipeline.h
+extern struct Sample_Ring Trip_Samples; //Выборки из прерывания DRDY (High_water, Overflows - команда "trip")
+extern volatile uint32_t Trip_Latency_max_cycles; //Максимум от входа в обработчик DRDY до записи выхода, такты Clock_Now()
+extern volatile uint32_t Trip_SPI_errors; //Таймауты SPI в обработчике DRDY
+
+void Trip_init(void); //Выход аварии, EXTI0 по спаду на PB0 (DRDY)
+void Trip_Set_Limits_degC(uint8_t Channel, float Low, float High, float Hysteresis); //Пределы в °C -> коды (с калибровкой канала)
+bool Trip_Evaluate(uint8_t Channel, uint16_t Code, uint8_t Status); //Шаг логики аварии. Возвращает состояние выхода
+void Trip_Reset(uint8_t Channel); //Снять защелку (если условие ушло)
+bool Trip_Take_Sample(struct Reading* Reading); //Самая старая выборка из прерывания (Code, Status, Timestamp). false - кольцо пусто
+void EXTI0_IRQHandler(void); //DRDY
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRIP_H */
@@ -0,0 +1,106 @@
+/**
+ ******************************************************************************
+ *  @file bus_sched.h
+ *  @brief Планировщик опроса каналов MAX31865 на одной шине SPI по ближайшему сроку (EDF)
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Каналам нужны разные частоты: 50 Гц для регулятора, 0.1 Гц для температуры
+ *  воздуха и т.п. У каждого канала свой период и свой относительный срок
+ *  (Deadline_ms <= Period_ms): к этому времени после выпуска задания код должен
+ *  быть прочитан и опубликован (reading.h).
+ *
+ *  Задание канала - это операции на шине:
+ *  - 1-shot (Deadline_ms >= BUS_SCHED_ONESHOT_MIN_MS - в срок помещается преобразование):
+ *    запуск (0x80, бит 1-shot), ожидание BUS_SCHED_CONVERSION_MS, чтение 7 байт; срок
+ *    запуска - середина запаса (Deadline_ms - BUS_SCHED_CONVERSION_MS) / 2, срок чтения -
+ *    срок задания;
+ *  - авто (срок короче): MAX31865 сам преобразует каждые 20 мс, задание - одно чтение.
+ *  Из готовых операций всех каналов выполняется та, у которой срок раньше.
+ *  Операция на шине не прерывается (десятки мкс), поэтому Bus_Sched_Poll()
+ *  выполняет одну операцию за вызов - звать как можно чаще из основного цикла.
+ *
+ *  Допуск канала (Bus_Sched_Add()): плотность загрузки
+ *      сумма (C_запуска + C_чтения) / min(T, окно)
+ *  по всем каналам не больше BUS_SCHED_LOAD_MAX_PERMILLE (запас на неделимую
+ *  операцию и обработчики прерываний). C - стоимость операции в тактах: при допуске
+ *  она измеряется пробной транзакцией с каналом, потом копится максимум по факту
+ *  (чтение - вместе с пересчетом и публикацией). Если по фактическим стоимостям
+ *  загрузка стала выше предела, поднимается Overload.
+ *
+ *  Промах срока: чтение закончилось позже срока - Misses, Lateness_max.
+ *  Таймаут SPI (Errors): запуск остается в очереди и повторяется, неудачное чтение
+ *  закрывает задание без публикации.
+ *  Если к концу задания следующий выпуск уже прошел, пропущенные выпуски не
+ *  копятся в очередь, а считаются в Skipped - канал не отнимает шину у других.
+ *
+ *  Время - Clock_Now() (такты 72 MHz и при смене частоты, clock_manager.h),
+ *  сравнения через знаковую разность, поэтому периоды не длиннее
+ *  BUS_SCHED_PERIOD_MAX_MS. Шину SPI с планировщиком больше никто не трогает.
+ *
+ *      Bus_Sched_Init(SPI1);
+ *      Bus_Sched_Add(0, &CS_table[0], 3, 20, 20); //50 Гц, регулятор
+ *      Bus_Sched_Add(1, &CS_table[1], 3, 10000, 10000); //0.1 Гц, воздух
+ *      while (1) { Bus_Sched_Poll(); ... }
+ ******************************************************************************
+ */
+
+#ifndef __BUS_SCHED_H
+#define __BUS_SCHED_H
+
+#include "max31865_sync.h"
+
+#define BUS_SCHED_CYCLES_PER_MS 72000 //Тактов Clock_Now() в мс (72MHz)
+#define BUS_SCHED_CONVERSION_MS 63 //Время 1-shot с фильтром 50 Гц (62.5 мс), мс
+#define BUS_SCHED_AUTO_PERIOD_MS 21 //Период автопреобразования с фильтром 50 Гц (20 мс) с запасом, мс
+#define BUS_SCHED_ONESHOT_MIN_MS (BUS_SCHED_CONVERSION_MS + 10) //Самый короткий срок (Deadline_ms) для режима 1-shot, мс
+#define BUS_SCHED_SPI_TIMEOUT_MS 2 //Таймаут операции SPI: 1 мс SysTick может обнулить сразу после взвода, мс
+#define BUS_SCHED_PERIOD_MAX_MS 20000 //Самый длинный период (знаковая разность CYCCNT - до 29 с), мс
+#define BUS_SCHED_LOAD_MAX_PERMILLE 900 //Предел загрузки шины при допуске, промилле
+#define BUS_SCHED_PUBLISH_CYCLES 30000 //Оценка пересчета и публикации (double) до первого фактического замера, такты
+
+//Фаза задания канала
+enum {
+	BUS_SCHED_IDLE, //Ждем выпуска
+	BUS_SCHED_TRIGGER, //Нужно запустить 1-shot
+	BUS_SCHED_CONVERTING, //Идет преобразование
+	BUS_SCHED_READ //Нужно прочитать
+};
+
+//Канал планировщика
+struct Bus_Sched_Channel {
+	/*----------Настройки----------*/
+	const struct MAX31865_CS* CS; //Ножка CS
+	uint16_t Period_ms; //Период выпуска заданий
+	uint16_t Deadline_ms; //Срок от выпуска до конца чтения
+	uint8_t Config; //Конфигурация без бита 1-shot
+	bool One_shot; //Режим 1-shot (иначе автопреобразование)
+	bool Admitted; //Канал принят
+	/*----------Состояние----------*/
+	uint8_t Phase; //BUS_SCHED_IDLE ...
+	uint32_t Release; //Выпуск текущего/следующего задания, такты
+	uint32_t Ready; //Когда операция готова к выполнению, такты
+	uint32_t Op_deadline; //Срок ближайшей операции, такты
+	uint32_t Job_deadline; //Срок задания, такты
+	uint32_t Edge; //Фронт CS запуска 1-shot (время измерения), такты
+	/*----------Статистика----------*/
+	uint32_t Cost_trigger; //Максимальная стоимость запуска, такты
+	uint32_t Cost_read; //Максимальная стоимость чтения с публикацией, такты
+	uint32_t Jobs; //Выполнено заданий
+	uint32_t Misses; //Промахов срока
+	uint32_t Skipped; //Пропущено выпусков
+	uint32_t Errors; //Таймаутов SPI
+	uint32_t Lateness_max; //Наибольшее опоздание, такты
+};
+
+extern struct Bus_Sched_Channel Bus_Sched_Table[CHANNEL_COUNT];
+extern bool Bus_Sched_Overload; //Фактическая загрузка выше BUS_SCHED_LOAD_MAX_PERMILLE
+
+void Bus_Sched_Init(SPI_TypeDef* SPI); //Сброс таблицы, выбор шины
+bool Bus_Sched_Add(uint8_t Channel, const struct MAX31865_CS* CS, uint8_t num_wires, uint16_t Period_ms, uint16_t Deadline_ms); //Допуск канала. false - не проходит по загрузке или срокам
+void Bus_Sched_Remove(uint8_t Channel); //Снять канал с опроса
+uint32_t Bus_Sched_Load_permille(void); //Текущая плотность загрузки шины по максимальным стоимостям
+bool Bus_Sched_Poll(void); //Одна операция на шине (если есть готовая). true - операция выполнена
+
+#endif /* __BUS_SCHED_H */
@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ *  @file crc32.h
+ *  @brief CRC-32 на аппаратном блоке CRC (с DMA или без) и совместимый программный расчет
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Блок CRC STM32F103: полином 0x04C11DB7, начальное значение 0xFFFFFFFF, слово
+ *  32 бита обрабатывается со старшего бита, без отражений и без финального XOR
+ *  (CRC-32/MPEG-2 над словами). Данные подаются так, как лежат в памяти МК:
+ *  4 байта -> слово little-endian; хвост из 1-3 байт дополняется нулями в
+ *  старших байтах последнего слова. CRC32_Soft() считает то же самое по
+ *  таблице на 256 слов, поэтому одинаково на МК и на ПК (host/crc32.c) - этим
+ *  CRC блока данных проверяется где угодно.
+ *
+ *  CRC32_Hard() кормит CRC->DR словами с процессора; CRC32_Hard_DMA_Start()
+ *  отдает выровненные слова каналу DMA в режиме память-память, процессор в
+ *  это время свободен, CRC32_Hard_DMA_Result() дописывает хвост и отдает результат.
+ *  Блок CRC один: не звать из прерываний и не начинать новый расчет, пока идет DMA.
+ *
+ *  Команда "crc" (telemetry.h) считает буфер CRC32_BENCH_SIZE байт всеми
+ *  способами, сверяет результаты и выдает такты каждого способа.
+ ******************************************************************************
+ */
+
+#ifndef __CRC32_H
+#define __CRC32_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRC32_INIT 0xFFFFFFFFUL //Начальное значение (как после CRC_CR_RESET)
+#define CRC32_POLY 0x04C11DB7UL //Полином блока CRC
+#define CRC32_DMA_CHANNEL DMA1_Channel3 //Канал DMA для режима память-память (Ch2/Ch5 заняты soft_spi.c)
+#define CRC32_DMA_TCIF DMA_ISR_TCIF3 //Флаг конца передачи этого канала
+#define CRC32_DMA_CLEAR (DMA_IFCR_CGIF3) //Сброс флагов этого канала
+#define CRC32_BENCH_SIZE 256 //Буфер для замера, байт
+
+//Замер тактов (команда "crc")
+struct CRC32_Bench {
+	uint32_t Soft_cycles; //Программный расчет по таблице
+	uint32_t Hard_cycles; //Блок CRC, слова с процессора
+	uint32_t DMA_cycles; //Блок CRC через DMA, от запуска до результата
+	bool Match; //Все три результата совпали
+};
+
+uint32_t CRC32_Soft(uint32_t Crc, const void* Data, uint32_t Size); //Программный расчет (начало - CRC32_INIT), продолжение с Crc
+
+#if defined (STM32F103xB) //Сборка прошивки (на ПК - только программный расчет)
+void CRC32_init(void); //Тактирование блока CRC и DMA1
+uint32_t CRC32_Hard(const void* Data, uint32_t Size); //Аппаратный расчет с CRC32_INIT
+bool CRC32_Hard_DMA_Start(const void* Data, uint32_t Size); //Запуск через DMA. false - блок занят или данные не выровнены
+bool CRC32_Hard_DMA_Result(uint32_t* Crc); //true - расчет закончен, результат в *Crc
+void CRC32_Bench_Run(struct CRC32_Bench* Bench); //Замер тактов трех способов на CRC32_BENCH_SIZE байтах
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRC32_H */
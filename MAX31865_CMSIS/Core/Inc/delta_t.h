@@ -0,0 +1,55 @@
+/**
+ ******************************************************************************
+ *  @file delta_t.h
+ *  @brief Разность температур пары датчиков в кодах АЦП с общей калибровкой
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Для тепловых потоков важна разность двух ТС, а не их абсолютные значения.
+ *  Вычитать две независимо пересчитанные температуры плохо: каналы разнесены
+ *  во времени, каждый несет свою ошибку пересчета, шум не коррелирован.
+ *
+ *  Здесь пара берется из одного синхронного снимка (max31865_sync.h) -
+ *  оба преобразования запущены с разбросом в микросекунды и прочитаны подряд.
+ *  Разность считается прямо в кодах, каждый со своей калибровкой (channel_table.h),
+ *  целочисленно в Q15 (Pipeline_Delta_code_Q8()):
+ *      ΔКод = Код_кал_a - Код_кал_b
+ *  Разница смещений и наклонов датчиков - главная ошибка ΔT - убирается калибровкой
+ *  до разности, синфазные ошибки (дрейф, наводки, общий нагрев) уходят до фильтра. Фильтр (ФНЧ первого
+ *  порядка, Q8) работает по самой разности; при скачке больше DELTA_T_STEP_CODES
+ *  фильтр перезапускается значением скачка, чтобы не тянуть реальный перепад.
+ *
+ *  Перевод в мК - целочисленный, через наклон dКод/dT в средней точке пары
+ *  (по калиброванным кодам).
+ *  Наклон (double, один раз) пересчитывается, только когда средний код ушел
+ *  больше чем на DELTA_T_SLOPE_REFRESH кодов (наклон Pt385 меняется ~0.03% на °C).
+ ******************************************************************************
+ */
+
+#ifndef __DELTA_T_H
+#define __DELTA_T_H
+
+#include "max31865_sync.h"
+
+#define DELTA_T_FILTER_SHIFT  2  //Фильтр разности: F += (ΔКод * 256 - F) >> DELTA_T_FILTER_SHIFT
+#define DELTA_T_STEP_CODES    40 //Скачок разности, при котором фильтр перезапускается, коды (~1.4 °C)
+#define DELTA_T_SLOPE_REFRESH 30 //Уход среднего кода, после которого пересчитывается наклон, коды (~1 °C)
+
+//Пара каналов
+struct Delta_T_Pair {
+	uint8_t Channel_a; //ΔT = T_a - T_b
+	uint8_t Channel_b;
+	int32_t Filter; //Отфильтрованная разность, Q8 (коды * 256)
+	int32_t Mean_code; //Средний калиброванный код, при котором считался наклон (-1 - еще не считался)
+	int32_t mK_per_code_Q16; //мК на код, Q16
+	int32_t Delta_raw_mK; //Разность последнего снимка без фильтра, мК
+	int32_t Delta_mK; //Отфильтрованная разность, мК
+	uint32_t Skew_cycles; //Разброс запуска каналов пары в последнем снимке, такты
+	uint32_t Count; //Обработано снимков
+};
+
+void Delta_T_Init(struct Delta_T_Pair* Pair, uint8_t Channel_a, uint8_t Channel_b); //Начальное состояние пары
+bool Delta_T_Update(struct Delta_T_Pair* Pair, const struct MAX31865_Snapshot* Snapshot); //Новый снимок. false - снимок неполный или ошибка датчика
+
+#endif /* __DELTA_T_H */
@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ *  @file fault_log.h
+ *  @brief Расшифровка ошибок MAX31865, счетчики по битам и журнал событий в ОЗУ
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Регистр Fault Status (адрес 0x07) читается в той же пачке из 7 байт, что и
+ *  код сопротивления (MAX31865_Get_Code()), поэтому расшифровка не стоит ни
+ *  одного лишнего обращения к SPI. Биты (datasheet MAX31865, Table 7):
+ *      D7 - RTD выше High Fault Threshold
+ *      D6 - RTD ниже Low Fault Threshold
+ *      D5 - REFIN- > 0.85 x VBIAS
+ *      D4 - REFIN- < 0.85 x VBIAS (FORCE- разомкнут)
+ *      D3 - RTDIN- < 0.85 x VBIAS (FORCE- разомкнут)
+ *      D2 - перенапряжение / недонапряжение на входах
+ *
+ *  Fault_Log_Record() увеличивает счетчик каждого выставленного бита канала (с насыщением) и
+ *  кладет событие (время, канал, регистр) в кольцевой журнал на FAULT_LOG_SIZE
+ *  записей - при переполнении затираются самые старые. Так видно перемежающиеся
+ *  обрывы проводки, которые автоматический сброс ошибки раньше прятал.
+ *  Выгрузка - команда "fault" (telemetry.h).
+ *
+ *  Запись и чтение журнала - из основного цикла (не из прерываний).
+ ******************************************************************************
+ */
+
+#ifndef __FAULT_LOG_H
+#define __FAULT_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "reading.h"
+
+#define FAULT_LOG_SIZE 16 //Записей в журнале (степень двойки)
+
+//Биты регистра Fault Status, по порядку от D7
+enum MAX31865_Fault {
+	MAX31865_FAULT_RTD_HIGH, //D7: RTD выше верхнего порога
+	MAX31865_FAULT_RTD_LOW, //D6: RTD ниже нижнего порога
+	MAX31865_FAULT_REFIN_HIGH, //D5: REFIN- > 0.85 x VBIAS
+	MAX31865_FAULT_REFIN_LOW, //D4: REFIN- < 0.85 x VBIAS
+	MAX31865_FAULT_RTDIN_LOW, //D3: RTDIN- < 0.85 x VBIAS
+	MAX31865_FAULT_OVUV, //D2: перенапряжение / недонапряжение
+	MAX31865_FAULT_COUNT
+};
+
+#define MAX31865_FAULT_MASK(Fault) (0x80 >> (Fault)) //Маска бита в регистре Fault Status
+
+//Событие журнала
+struct Fault_Event {
+	uint32_t Time_ms; //SysTimer_ms в момент обнаружения
+	uint8_t Channel; //Номер канала
+	uint8_t Status; //Регистр Fault Status целиком
+};
+
+//Журнал и счетчики
+struct Fault_Log {
+	uint16_t Counters[MAX31865_FAULT_COUNT][CHANNEL_COUNT]; //Сколько раз выставлялся каждый бит (до 65535, дальше не растет)
+	struct Fault_Event Events[FAULT_LOG_SIZE]; //Кольцо событий
+	uint32_t Total; //Сколько событий записано всего (индекс следующего = Total % FAULT_LOG_SIZE)
+};
+
+extern struct Fault_Log Fault_Log;
+
+void Fault_Log_Record(uint8_t Channel, uint8_t Status); //Учет ненулевого регистра Fault Status
+void Fault_Log_Reset(void); //Очистка журнала и счетчиков
+const char* Fault_Log_Name(enum MAX31865_Fault Fault); //Короткое имя бита для телеметрии
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FAULT_LOG_H */
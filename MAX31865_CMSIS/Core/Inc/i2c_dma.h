@@ -0,0 +1,112 @@
+/**
+ ******************************************************************************
+ *  @file i2c_dma.h
+ *  @brief Неблокирующий I2C1: очередь запросов, автомат на прерываниях EV/ER и DMA
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  CMSIS_I2C_MemWrite() / CMSIS_I2C_MemRead() ждут каждый флаг SB/ADDR/TXE/BTF
+ *  в цикле, и на время обмена с EEPROM опрос датчиков стоит. Здесь запрос
+ *  (struct I2C_DMA_Request) ставится в очередь I2C_DMA_Submit() и сразу
+ *  возвращается; дальше обмен ведут прерывания I2C1_EV / I2C1_ER и DMA:
+ *      START -> SB: адрес -> ADDR -> байты адреса памяти (TXE) ->
+ *      запись: данные через DMA1 Channel6, BTF -> STOP;
+ *      чтение: BTF -> повторный START -> SB: адрес|1 -> ADDR -> данные.
+ *  Состояние запроса (Status) и, если задан, Callback (из прерывания!) говорят
+ *  о результате; следующий запрос из очереди запускается из того же прерывания.
+ *
+ *  Прием на F103 (RM0008 п. 26.3.3, errata "I2C event management"):
+ *  - N >= 3 байт: DMA1 Channel7, ACK = 1 и LAST = 1 - NACK на последнем байте
+ *    ставит сам блок, STOP - в прерывании конца DMA;
+ *  - N = 2: без DMA. POS = 1 и ACK = 1 до START, после ADDR ACK = 0, по BTF
+ *    (оба байта приняты) - STOP и два чтения DR;
+ *  - N = 1: без DMA. ACK = 0 до сброса ADDR, сброс ADDR и STOP - подряд с
+ *    запрещенными прерываниями, затем байт по RXNE.
+ *  Окна с запретом прерываний - несколько тактов, только там, где этого требует errata.
+ *
+ *  Очередь "один писатель - один читатель" без блокировок (как sample_ring.h):
+ *  I2C_DMA_Submit() зовется только из основного цикла, забирает запросы
+ *  прерывание I2C1_EV (Submit при пустой шине просто ставит его в ожидание).
+ *  Запрос и его буфер должны жить, пока Status == I2C_DMA_PENDING.
+ *
+ *  Зависание (нет ответа, шина держится) ловит I2C_DMA_Poll() из основного
+ *  цикла: запрос дольше I2C_DMA_TIMEOUT_MS снимается со статусом
+ *  I2C_DMA_TIMEOUT, блок I2C1 перезапускается.
+ *
+ *  Ресурсы: I2C1 (PB6 SCL, PB7 SDA, настройка - CMSIS_I2C1_Init()), DMA1
+ *  Channel6 (TX) и Channel7 (RX) - свободны от soft_spi.c и crc32.c. Пока
+ *  работает очередь, блокирующими CMSIS_I2C_*() на I2C1 пользоваться нельзя.
+ *  Страницы EEPROM и ожидание конца записи (NACK во время цикла записи) -
+ *  забота вызывающего. Делители I2C1 рассчитаны на PCLK1 = 36 MHz; на 8 MHz
+ *  (USE_CLOCK_SCALING) SCL просто медленнее - шина синхронная, обмен не портится.
+ ******************************************************************************
+ */
+
+#ifndef __I2C_DMA_H
+#define __I2C_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f103xx_CMSIS.h"
+
+/*----------Включение I2C через DMA----------*/
+//#define USE_I2C_DMA   //Раскомментировать: обработчики I2C1_EV/ER и DMA1 Channel6/7, очередь запросов
+/*----------Включение I2C через DMA----------*/
+
+#define I2C_DMA_QUEUE_SIZE 8 //Запросов в очереди (степень двойки)
+#define I2C_DMA_TIMEOUT_MS 50 //Предельное время одного запроса, мс
+#define I2C_DMA_IRQ_PRIORITY 2 //Приоритет I2C1_EV/ER и DMA1 Channel6/7 (общий - обработчики не вытесняют друг друга)
+#define I2C_DMA_STOP_SPIN 2000 //Предел ожидания конца STOP перед следующим START, итераций
+
+_Static_assert((I2C_DMA_QUEUE_SIZE & (I2C_DMA_QUEUE_SIZE - 1)) == 0, "I2C_DMA_QUEUE_SIZE must be a power of two");
+
+//Состояние запроса
+enum {
+	I2C_DMA_PENDING = 0, //В очереди или на шине
+	I2C_DMA_DONE, //Выполнен
+	I2C_DMA_NACK, //Устройство не ответило (адрес или данные)
+	I2C_DMA_ERROR, //Ошибка шины (BERR, ARLO, OVR, DMA) или шина занята
+	I2C_DMA_TIMEOUT //Снят по I2C_DMA_TIMEOUT_MS
+};
+
+//Запрос к устройству на I2C1
+struct I2C_DMA_Request {
+	uint8_t Adress_Device; //7-битный адрес устройства
+	uint8_t Size_adress; //Байт адреса памяти: 0, 1 или 2 (старший первым)
+	uint16_t Adress_data; //Адрес памяти в устройстве
+	bool Read; //true - чтение, false - запись
+	uint8_t* data; //Буфер данных
+	uint16_t Size_data; //Байт данных (для чтения не меньше 1)
+	void (*Callback)(struct I2C_DMA_Request* Request); //Вызывается из прерывания по завершении (можно NULL)
+	volatile uint8_t Status; //I2C_DMA_PENDING ... I2C_DMA_TIMEOUT
+};
+
+//Статистика (команда "i2c")
+struct I2C_DMA_Stats {
+	uint32_t Done; //Выполнено запросов
+	uint32_t Nacks; //Без ответа
+	uint32_t Errors; //Ошибки шины и DMA
+	uint32_t Timeouts; //Сняты по таймауту
+	uint32_t Rejected; //Не принято: очередь полна или запрос неверный
+	uint32_t Queue_max; //Наибольшая длина очереди
+};
+
+#if defined (USE_I2C_DMA)
+
+extern struct I2C_DMA_Stats I2C_DMA_Stats;
+
+void I2C_DMA_init(void); //CMSIS_I2C1_Init(), DMA1 Channel6/7, прерывания
+bool I2C_DMA_Submit(struct I2C_DMA_Request* Request); //В очередь (только из основного цикла). false - очередь полна или запрос неверный
+void I2C_DMA_Poll(void); //Контроль таймаута (из основного цикла)
+bool I2C_DMA_Busy(void); //true - есть запрос на шине или в очереди
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __I2C_DMA_H */
@@ -0,0 +1,61 @@
+/**
+ ******************************************************************************
+ *  @file mem_usage.h
+ *  @brief Контроль использования ОЗУ: глубина стека и куча _sbrk
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Файлы .su из Debug показывают стек отдельных функций, но не реальную глубину
+ *  с учетом вложенных вызовов и прерываний. Поэтому стек меряется по факту:
+ *  Mem_Usage_Stack_Paint() в самом начале main() заполняет свободное ОЗУ между
+ *  кучей и текущей вершиной стека словом MEM_USAGE_STACK_PATTERN, а
+ *  Mem_Usage_Get() ищет снизу первое затертое слово - это максимальная глубина
+ *  стека MSP с момента старта (high-water mark).
+ *
+ *  Куча: _sbrk() в sysmem.c копит пик занятого объема и число отказов.
+ *  Нижняя граница поиска по стеку сдвигается на пик кучи, чтобы данные кучи
+ *  не принимались за стек.
+ *
+ *  RTOS в проекте нет, поэтому стек один (MSP).
+ *
+ *  Карта ОЗУ (см. STM32F103C8TX_FLASH.ld):
+ *      | .ramfunc | .data | .bss | куча -> ... свободно ... <- стек MSP |
+ *      ^_sramfunc                ^_end                            _estack^
+ *  Результат выдается командой "mem" (telemetry.h). Если stack_peak с запасом
+ *  меньше stack_reserved (_Min_Stack_Size), резерв в .ld можно уменьшить.
+ ******************************************************************************
+ */
+
+#ifndef __MEM_USAGE_H
+#define __MEM_USAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define MEM_USAGE_STACK_PATTERN 0xA5A5A5A5 //Слово заполнения стека
+#define MEM_USAGE_PAINT_MARGIN  64         //Сколько байт под текущей вершиной стека не трогать
+
+//Снимок использования ОЗУ, все значения в байтах
+struct Mem_Usage {
+	uint32_t Static; //.ramfunc + .data + .bss
+	uint32_t Heap; //Занято кучей сейчас
+	uint32_t Heap_peak; //Пик кучи
+	uint32_t Heap_failures; //Сколько раз _sbrk() отказал (ENOMEM)
+	uint32_t Stack_reserved; //Резерв стека в .ld (_Min_Stack_Size)
+	uint32_t Stack_peak; //Максимальная глубина стека с момента Mem_Usage_Stack_Paint()
+	uint32_t Free_min; //Минимум свободного ОЗУ между кучей и стеком
+};
+
+void Mem_Usage_Stack_Paint(void); //Заполнение свободного стека шаблоном (первой строкой main())
+uint32_t Mem_Usage_Stack_Peak(void); //Максимальная глубина стека, байт
+void Mem_Usage_Get(struct Mem_Usage* Usage); //Полный снимок
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MEM_USAGE_H */
@@ -0,0 +1,56 @@
+/**
+ ******************************************************************************
+ *  @file pid_code_space.h
+ *  @brief ПИД-регулирование напрямую в кодах АЦП MAX31865
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Обычный путь измерения: код -> MAX31865_Get_Resistance() -> MAX31865_Get_Temperature(),
+ *  оба шага в double (программная эмуляция на Cortex-M3) - это самая дорогая часть контура.
+ *
+ *  Здесь уставка и коэффициенты один раз переводятся в единицы 15-битного кода АЦП:
+ *  - уставка: Pipeline_Code_degC() - сопротивление Pt100 -> обратная калибровка канала
+ *    (Cal_gain, Cal_offset из Channel_Set_Calibration(), channel_table.h) -> код;
+ *  - коэффициенты: делятся на локальный наклон dКод/dT в точке уставки.
+ *  После этого каждый шаг регулятора - это PID_Compute() над кодом из MAX31865_Get_Code(),
+ *  только целочисленная арифметика. Пересчет (линеаризация) делается заново только при смене
+ *  уставки, коэффициентов или калибровки.
+ *
+ *  Погрешность: наклон характеристики Pt385 меняется примерно на 0.3% на каждые 10 °C,
+ *  поэтому на установившийся режим (ошибка -> 0) линеаризация не влияет, а эффективное
+ *  усиление при больших отклонениях от уставки отличается от заданного на доли процента.
+ ******************************************************************************
+ */
+
+#ifndef __PID_CODE_SPACE_H
+#define __PID_CODE_SPACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid_controller.h"
+
+//Параметры пересчета температуры в код АЦП
+struct PID_Code_Space {
+	/*----------Параметры (в температурной области)----------*/
+	int32_t Kp, Ki, Kd; //Коэффициенты, Q16.16, тактов ШИМ на 0.01 °C (как в pid_controller.h)
+	float Setpoint; //Уставка, °C
+	uint8_t Channel; //Канал датчика: характеристика и калибровка - как в Pipeline_Publish()
+	/*----------Результат линеаризации----------*/
+	float Codes_per_degC; //Локальный наклон в точке уставки, кодов на °C
+	bool Valid; //Линеаризация выполнена для текущих параметров
+};
+
+void PID_Code_Space_Linearise(struct PID_Code_Space* CS, struct PID_Controller* PID); //Пересчет уставки и коэффициентов в коды АЦП
+void PID_Code_Space_Set_Setpoint(struct PID_Code_Space* CS, struct PID_Controller* PID, float Setpoint); //Смена уставки (линеаризация только если уставка изменилась)
+uint16_t PID_Code_Space_Temperature_To_Code(const struct PID_Code_Space* CS, float Temperature); //Температура -> код АЦП
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PID_CODE_SPACE_H */
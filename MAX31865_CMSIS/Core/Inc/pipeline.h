@@ -0,0 +1,127 @@
+/**
+ ******************************************************************************
+ *  @file pipeline.h
+ *  @brief Обработка измерения после чтения кода: калибровка, температура, аварии, регулятор
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Все, что происходит с кодом АЦП после чтения по SPI, собрано здесь и не
+ *  зависит от железа (ни регистров, ни stm32f1xx.h): код -> таблица каналов
+ *  и калибровка -> сопротивление -> температура (rtd_calculator.c) -> публикация
+ *  и журнал ошибок -> шаг аварии в кодах -> прогноз выхода за пределы -> шаг регулятора.
+ *
+ *  Прошивка зовет эти функции из MAX31865_Publish(), trip.c и heater_control.c,
+ *  а host/replay.c - те же исходники на ПК над записанными кодами. Поэтому
+ *  результат на ПК совпадает с МК до бита: в тракте только целые, float/double
+ *  сложение, умножение, деление и sqrt (IEEE, округление к ближайшему), а
+ *  host/Makefile собирает с -ffp-contract=off (без FMA, которого нет на Cortex-M3).
+ *
+ *  Предварительная авария (Pipeline_Trend_Step()): авария в кодах срабатывает, только
+ *  когда предел уже пройден. Здесь по скользящему окну из TREND_WINDOW точек (точка -
+ *  сумма Decimation кодов подряд) ведется линейная регрессия код(номер точки): суммы
+ *  Σy и Σk*y обновляются за O(1) на точку - уходящая точка вычитается, все номера
+ *  сдвигаются на 1, новая добавляется с номером TREND_WINDOW - 1:
+ *      Σk*y' = Σk*y - (Σy - y_старая) + (TREND_WINDOW - 1) * y_новая
+ *  Суммы целые (точно, без накопления ошибки), наклон и время до предела - в double
+ *  раз на Decimation выборок. Время до предела = (предел - код по прямой в последней
+ *  точке) / наклон * средний интервал между точками. Предварительная авария - если оно
+ *  не больше Horizon_ms, снимается, когда стало больше Horizon_ms + 25%. Точки считаются
+ *  равноотстоящими (интервал - скользящее среднее по Timestamp), квадратичный член не
+ *  берется: на горизонте в минуты он меньше шума наклона.
+ *  Интервал между точками - разность 32-битных Timestamp, поэтому Decimation * период
+ *  выборок должен быть меньше периода переполнения Timestamp: для Clock_Now() (такты
+ *  72 MHz) это 2^32 / 72 MHz = 59.6 с, иначе интервал молча укорачивается на период.
+ *  Окно целиком (TREND_WINDOW точек) может быть и длиннее.
+ ******************************************************************************
+ */
+
+#ifndef __PIPELINE_H
+#define __PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ramfunc.h"
+#include "rtd_calculator.h"
+#include "reading.h"
+#include "pid_controller.h"
+
+/*--------------Характеристики датчика типа PT100 и референсный резистор, подключенный к MAX31865------------*/
+#define MAX31865_PT100_R0 (double)100.0 //Сопротивление датчика PT100, при 0 °С
+#define MAX31865_R_REF (double)428.5 //Сопротивление референсного резистора, подключенного к MAX31865
+/*--------------Характеристики датчика типа PT100 и референсный резистор, подключенный к MAX31865------------*/
+
+/*----------Регулятор нагревателя (heater_control.c, host/replay.c)----------*/
+#define HEATER_PWM_PERIOD   1000 //Период ШИМ в тактах: 1000 мкс (1 кГц). Выход регулятора 0...HEATER_PWM_PERIOD
+#define HEATER_PID_KP       PID_Q16(0.5) //Коэффициенты в тактах ШИМ на 0.01 °C
+#define HEATER_PID_KI       PID_Q16(0.01)
+#define HEATER_PID_KD       PID_Q16(2.0)
+#define HEATER_PID_SLEW_MAX (HEATER_PWM_PERIOD / 10) //Не более 10% мощности за шаг
+#define HEATER_PID_SETPOINT 5000 //Уставка по умолчанию, 0.01 °C (50.00 °C)
+/*----------Регулятор нагревателя (heater_control.c, host/replay.c)----------*/
+
+//Настройка и состояние аварии одного канала (trip.h)
+struct Trip_Channel {
+	/*----------Настройки----------*/
+	uint16_t High_code; //Авария, если код выше
+	uint16_t Low_code; //Авария, если код ниже
+	uint16_t Hysteresis; //Возврат, когда код внутри пределов на столько кодов
+	uint8_t Delay_on; //Выборок подряд за пределом до аварии (0 и 1 - сразу)
+	bool Latching; //Авария держится до Trip_Reset()
+	bool On_fault; //Ошибка датчика (Fault Status) - тоже авария
+	bool Enabled;
+	/*----------Состояние----------*/
+	uint8_t Counter; //Выборок подряд за пределом
+	bool Tripped; //Авария активна
+	uint32_t Trip_count; //Сколько раз срабатывала
+};
+
+#ifndef TREND_WINDOW
+#define TREND_WINDOW 32 //Точек в окне регрессии
+#endif
+_Static_assert(TREND_WINDOW >= 3 && TREND_WINDOW <= 64, "TREND_WINDOW must be 3..64");
+
+//Прогноз выхода за пределы одного канала
+struct Trend_Channel {
+	/*----------Настройки----------*/
+	uint16_t High_code; //Предел сверху, код (как в Trip_Channel)
+	uint16_t Low_code; //Предел снизу, код
+	uint32_t Horizon_ms; //Предварительная авария, если до предела осталось не больше, мс
+	uint32_t Ticks_per_ms; //Единиц Reading.Timestamp в мс (CLOCK_NOW_PER_US * 1000 - Clock_Now(), 1 - host/replay.c)
+	uint8_t Decimation; //Выборок на точку окна (сумма - меньше шум и длиннее окно). Decimation * период выборок < 59.6 с
+	bool Enabled;
+	/*----------Состояние----------*/
+	uint32_t Window[TREND_WINDOW]; //Точки (сумма Decimation кодов), кольцо
+	uint8_t Head; //Самая старая точка
+	uint8_t Points; //Точек в окне
+	uint8_t Accumulated; //Выборок в текущей точке
+	uint32_t Accumulator; //Сумма кодов текущей точки
+	uint32_t Sum; //Σy по окну
+	int64_t Weighted; //Σk*y по окну, k = 0 - самая старая
+	uint32_t Point_timestamp; //Timestamp последней точки
+	uint32_t Interval; //Средний интервал между точками, единиц Timestamp
+	uint32_t Time_to_limit_ms; //Прогноз до ближайшего предела (UINT32_MAX - не приближаемся)
+	bool Pre_alarm; //Предварительная авария активна
+	uint32_t Pre_alarm_count; //Сколько раз срабатывала
+};
+
+RAMFUNC void Pipeline_Publish(uint8_t Channel, struct Reading* Reading); //Код -> калибровка -> температура -> публикация и журнал
+int32_t Pipeline_Centi_degC(float Temperature); //°C -> 0.01 °C для регулятора (с округлением)
+void Pipeline_Heater_Init(struct PID_Controller* PID, int32_t Setpoint); //Регулятор нагревателя: выход 0...HEATER_PWM_PERIOD, HEATER_PID_*, уставка 0.01 °C, ручной режим
+bool Pipeline_Trip_Step(struct Trip_Channel* Trip, uint16_t Code, uint8_t Status); //Шаг логики аварии канала. Возвращает Tripped
+void Pipeline_Trip_Limits_degC(struct Trip_Channel* Trip, uint8_t Channel, float Low, float High, float Hysteresis); //Пределы в °C -> коды (с калибровкой канала)
+double Pipeline_Code_degC(uint8_t Channel, float Temperature); //°C -> код АЦП канала (обратная калибровка, без округления)
+int32_t Pipeline_mK_per_code_Q16(int32_t Code, double Step); //Наклон в точке калиброванного кода: мК/код, Q16
+int32_t Pipeline_Delta_code_Q8(uint8_t Channel_a, uint16_t Code_a, uint8_t Channel_b, uint16_t Code_b); //Разность калиброванных кодов каналов, Q8
+bool Pipeline_Trend_Step(struct Trend_Channel* Trend, const struct Reading* Reading); //Новая выборка в прогноз. Возвращает Pre_alarm
+void Pipeline_Trend_Limits_degC(struct Trend_Channel* Trend, uint8_t Channel, float Low, float High, uint32_t Horizon_s); //Пределы в °C -> коды, горизонт прогноза; сброс окна
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PIPELINE_H */
@@ -0,0 +1,110 @@
+/**
+ ******************************************************************************
+ *  @file profiler.h
+ *  @brief Профилировщик горячих участков по счетчику тактов DWT (Clock_Now())
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Участок кода оборачивается макросами:
+ *      PROFILER_BEGIN(PROFILER_SPI_RX);
+ *      CMSIS_SPI_Data_Receive_8BIT(...);
+ *      PROFILER_END(PROFILER_SPI_RX);
+ *  Для каждого участка в статической таблице копятся: количество, минимум, максимум,
+ *  сумма тактов Clock_Now() (72 MHz и при смене частоты, clock_manager.h) и гистограмма по степеням двойки (корзина i: 2^i <= такты < 2^(i+1)).
+ *  Таблицу можно выгрузить по USART (Profiler_Dump(), команда "prof" в telemetry.c).
+ *
+ *  Пока USE_PROFILER не определен, макросы раскрываются в пустые операторы
+ *  и профилировщик не занимает ни ОЗУ, ни тактов.
+ *
+ *  Замеры "грязные": прерывание, пришедшее внутри участка, входит в его время.
+ *  Один и тот же участок нельзя одновременно мерить из прерывания и из основного цикла.
+ ******************************************************************************
+ */
+
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stm32f1xx.h>
+#include <stdint.h>
+
+/*----------Включение профилировщика----------*/
+//#define USE_PROFILER   //Раскомментировать, чтобы собрать с профилировщиком
+/*----------Включение профилировщика----------*/
+
+#define PROFILER_HISTOGRAM_SIZE 24 //Корзин гистограммы: до 2^24 тактов (233 мс на 72MHz), дальше - в последнюю
+
+//Участки, которые меряем
+enum {
+	PROFILER_MAX31865_GET_CODE, //MAX31865_Get_Code() целиком (SPI + разбор + реакция на ошибку)
+	PROFILER_SPI_TX, //Передача адреса регистра MAX31865
+	PROFILER_SPI_RX, //Прием регистров MAX31865
+	PROFILER_CONVERSION, //MAX31865_Get_Temperature() или Pipeline_Publish() (double)
+	PROFILER_READ_AND_CONVERT, //Весь путь код -> сопротивление -> температура в основном цикле
+	PROFILER_HEATER_UPDATE, //Шаг регулятора нагревателя с записью TIM3->CCR1
+	PROFILER_SYSTICK_IRQ, //SysTick_Handler
+	PROFILER_USART1_IRQ, //USART1_IRQHandler
+	PROFILER_REGIONS_COUNT
+};
+
+//Статистика по одному участку
+struct Profiler_Region {
+	uint32_t Count; //Сколько раз прошли участок
+	uint32_t Min; //Минимум, такты
+	uint32_t Max; //Максимум, такты
+	uint64_t Sum; //Сумма, такты (среднее = Sum / Count)
+	uint32_t Histogram[PROFILER_HISTOGRAM_SIZE]; //Гистограмма log2
+};
+
+#if defined (USE_PROFILER)
+
+#include "clock_manager.h"
+
+extern struct Profiler_Region Profiler_Table[PROFILER_REGIONS_COUNT];
+
+/*
+ **************************************************************************************************
+ *  @breif Учет одного замера участка
+ *  @attention inline, чтобы вызов не добавлял тактов к соседним замерам.
+ **************************************************************************************************
+ */
+static inline void Profiler_Record(uint32_t Region, uint32_t Cycles) {
+	struct Profiler_Region* R = &Profiler_Table[Region];
+	uint32_t Bucket = Cycles ? 31 - __CLZ(Cycles) : 0;
+	if (Bucket >= PROFILER_HISTOGRAM_SIZE) {
+		Bucket = PROFILER_HISTOGRAM_SIZE - 1;
+	}
+	R->Count++;
+	R->Sum += Cycles;
+	if (Cycles < R->Min) {
+		R->Min = Cycles;
+	}
+	if (Cycles > R->Max) {
+		R->Max = Cycles;
+	}
+	R->Histogram[Bucket]++;
+}
+
+#define PROFILER_BEGIN(Region) uint32_t Profiler_start_##Region = Clock_Now()
+#define PROFILER_END(Region) Profiler_Record((Region), Clock_Now() - Profiler_start_##Region)
+
+void Profiler_Init(void); //Запуск DWT->CYCCNT и очистка таблицы
+void Profiler_Reset(void); //Очистка таблицы
+void Profiler_Dump(USART_TypeDef* USART); //Выгрузка таблицы текстом по USART
+
+#else
+
+#define PROFILER_BEGIN(Region) (void) 0
+#define PROFILER_END(Region) (void) 0
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROFILER_H */
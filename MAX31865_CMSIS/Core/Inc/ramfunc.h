@@ -0,0 +1,42 @@
+/**
+ ******************************************************************************
+ *  @file ramfunc.h
+ *  @brief Размещение горячих функций в ОЗУ (секция .ramfunc)
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  На 72MHz flash F103 работает с 2 тактами ожидания (FLASH_ACR_LATENCY_2).
+ *  Буфер предвыборки прячет их на линейном коде, но каждый переход в цикле
+ *  опроса флагов SPI или в ветвистом разборе стоит лишних тактов.
+ *
+ *  Функция, помеченная RAMFUNC, попадает в секцию .ramfunc: скрипт компоновщика
+ *  (STM32F103C8TX_FLASH.ld) кладет ее образ во flash, а Reset_Handler
+ *  (startup_stm32f103c8tx.S) копирует в ОЗУ до вызова main(). Вызов идет через
+ *  long_call, т.к. ОЗУ (0x20000000) вне досягаемости инструкции BL из flash.
+ *  Вызовы из ОЗУ обратно во flash (soft-float, CMSIS-функции) компоновщик
+ *  оформляет сам через veneer.
+ *
+ *  Пока USE_RAMFUNC не определен, RAMFUNC пустой и все остается во flash -
+ *  так удобно сравнить такты "до/после" профилировщиком (участки get_code,
+ *  conversion, read_convert в profiler.h). Каждая функция в ОЗУ отнимает ОЗУ
+ *  у буферов выборок, поэтому помечать стоит только то, что видно в профиле.
+ *
+ *  На ПК (host/) макрос всегда пустой.
+ ******************************************************************************
+ */
+
+#ifndef __RAMFUNC_H
+#define __RAMFUNC_H
+
+/*----------Выполнение горячих функций из ОЗУ----------*/
+//#define USE_RAMFUNC   //Раскомментировать, чтобы перенести функции с RAMFUNC в ОЗУ
+/*----------Выполнение горячих функций из ОЗУ----------*/
+
+#if defined (USE_RAMFUNC) && defined (__arm__)
+#define RAMFUNC __attribute__((section(".ramfunc"), long_call, noinline))
+#else
+#define RAMFUNC
+#endif
+
+#endif /* __RAMFUNC_H */
@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ *  @file sample_ring.h
+ *  @brief Кольцевой буфер измерений "один писатель - один читатель" без блокировок
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Передача измерений из прерывания или DMA в основной цикл без запрета
+ *  прерываний: писатель (прерывание) двигает только Head, читатель (основной
+ *  цикл) - только Tail. Индексы идут без сброса, позиция в буфере - индекс &
+ *  (SAMPLE_RING_SIZE - 1), поэтому размер - степень двойки, а занятость -
+ *  просто Head - Tail (и при переполнении uint32_t).
+ *
+ *  Барьеры: писатель сначала пишет запись, потом барьер, потом Head; читатель
+ *  читает Head, барьер, запись, барьер, Tail. На Cortex-M3 это __DMB() (он же
+ *  барьер компилятора; нужен и для записей, которые кладет DMA). На ПК - атомарные
+ *  загрузки/сохранения acquire/release, так что тот же код работает между потоками.
+ *
+ *  Полный буфер: новая запись отбрасывается и считается в Overflows (счетчик
+ *  писателя), старые не портятся. High_water - наибольшая занятость, по нему
+ *  подбирается SAMPLE_RING_SIZE.
+ *
+ *  Писатель и читатель у каждого кольца ровно по одному. Два прерывания
+ *  разного приоритета в одно кольцо писать не могут - каждому свое кольцо.
+ ******************************************************************************
+ */
+
+#ifndef __SAMPLE_RING_H
+#define __SAMPLE_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "reading.h"
+
+#ifndef SAMPLE_RING_SIZE
+#define SAMPLE_RING_SIZE 16 //Записей в кольце, степень двойки
+#endif
+
+_Static_assert((SAMPLE_RING_SIZE & (SAMPLE_RING_SIZE - 1)) == 0 && SAMPLE_RING_SIZE >= 2, "SAMPLE_RING_SIZE must be a power of two");
+
+//Запись кольца: измерение и канал
+struct Sample_Ring_Record {
+	struct Reading Reading;
+	uint8_t Channel;
+};
+
+//Кольцо
+struct Sample_Ring {
+	volatile uint32_t Head; //Следующая запись писателя (пишет только писатель)
+	volatile uint32_t Tail; //Следующее чтение (пишет только читатель)
+	uint32_t High_water; //Наибольшая занятость, записей (пишет писатель)
+	uint32_t Overflows; //Отброшено записей из-за полного кольца (пишет писатель)
+	struct Sample_Ring_Record Buffer[SAMPLE_RING_SIZE];
+};
+
+void Sample_Ring_Init(struct Sample_Ring* Ring); //Пустое кольцо и нулевые счетчики (до запуска писателя)
+bool Sample_Ring_Push(struct Sample_Ring* Ring, uint8_t Channel, const struct Reading* Reading); //Писатель. false - кольцо полно, запись отброшена
+bool Sample_Ring_Pop(struct Sample_Ring* Ring, uint8_t* Channel, struct Reading* Reading); //Читатель. false - кольцо пусто
+uint32_t Sample_Ring_Count(const struct Sample_Ring* Ring); //Занятость сейчас (из любого контекста, оценка)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SAMPLE_RING_H */
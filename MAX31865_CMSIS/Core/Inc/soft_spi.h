@@ -0,0 +1,61 @@
+/**
+ ******************************************************************************
+ *  @file soft_spi.h
+ *  @brief Программный SPI на любых ножках одного порта: таймер + DMA, без участия CPU на каждый бит
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Аппаратных SPI у F103C8 два, а изолированных групп датчиков больше.
+ *  Здесь SCK и MOSI формируются DMA, который по событию таймера пишет в
+ *  GPIOx->BSRR заранее подготовленную таблицу (2 слова на бит), а MISO
+ *  читается вторым каналом DMA из GPIOx->IDR в середине каждого полупериода.
+ *
+ *  Ресурсы: TIM2 (период = полбита), DMA1 Channel2 (TIM2_UP -> BSRR),
+ *  DMA1 Channel5 (TIM2_CH1 -> чтение IDR). Эти каналы DMA заняты, пока идет
+ *  передача. Несколько шин (разные ножки) работают через один движок по очереди.
+ *
+ *  Режим SPI 3 (CPOL = 1, CPHA = 1), как у MAX31865: SCK в покое высокий,
+ *  MOSI меняется по спаду, MISO читается в середине высокого полупериода.
+ *  Таймлайн периода таймера: CC1 (середина) - чтение IDR, UP (конец) - запись BSRR.
+ *  Поэтому отсчет k видит состояние после записи k-1, и бит b MISO - это отсчет 2b+2.
+ *
+ *  Частота: SOFT_SPI_HZ, 1 MHz с запасом; 2 MHz - предел (18 тактов на полбита на
+ *  два запроса DMA), при загрузке шины другими DMA возможно растяжение тактов, но
+ *  не потеря данных - SPI синхронный. Такт TIM2 берется из текущих настроек RCC
+ *  перед каждой передачей, поэтому после Clock_Set() (clock_manager.h) шина
+ *  работает и на 8 MHz - медленнее: полбита не короче SOFT_SPI_HALF_MIN тактов
+ *  (8 MHz - 222 кГц).
+ *
+ *  Интерфейс как у CMSIS_SPI_Data_Transmit_8BIT / CMSIS_SPI_Data_Receive_8BIT,
+ *  CS ставится снаружи так же, как NSS_ON / NSS_OFF. Вызов блокирующий, CPU
+ *  только ждет флаг окончания DMA.
+ *  Модуль самостоятельный: драйвер MAX31865 (MAX31865.c) работает с SPI_TypeDef*
+ *  и его не использует. Датчик на программной шине читается вызывающим по образцу
+ *  MAX31865_Get_Code(): CS, адрес 0x01, 7 байт, CS.
+ ******************************************************************************
+ */
+
+#ifndef __SOFT_SPI_H
+#define __SOFT_SPI_H
+
+#include "stm32f103xx_CMSIS.h"
+
+#define SOFT_SPI_HZ        1000000  //Частота SCK, Гц (до 2 MHz)
+#define SOFT_SPI_HALF_MIN  18       //Наименьший полупериод, такты TIM2 (два запроса DMA)
+#define SOFT_SPI_MAX_BYTES 8        //Максимальная длина одной передачи, байт
+
+//Ножки одной программной шины (все на одном порту)
+struct Soft_SPI {
+	GPIO_TypeDef* Port;
+	uint8_t SCK; //Номер ножки SCK
+	uint8_t MOSI; //Номер ножки MOSI
+	uint8_t MISO; //Номер ножки MISO
+};
+
+void Soft_SPI_init(const struct Soft_SPI* Bus); //Настройка ножек шины и TIM2 (тактирование порта должно быть включено)
+bool Soft_SPI_Transfer(const struct Soft_SPI* Bus, const uint8_t* tx_data, uint8_t* rx_data, uint16_t Size_data, uint32_t Timeout_ms); //Полный дуплекс
+bool Soft_SPI_Data_Transmit_8BIT(const struct Soft_SPI* Bus, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Как CMSIS_SPI_Data_Transmit_8BIT
+bool Soft_SPI_Data_Receive_8BIT(const struct Soft_SPI* Bus, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Как CMSIS_SPI_Data_Receive_8BIT
+
+#endif /* __SOFT_SPI_H */
@@ -30,6 +30,7 @@ extern "C" {
 #include <main.h>
 #include <stdbool.h>
 #include <stm32f103xb.h>
+#include "ramfunc.h"
 
     //Структура по USART
     struct USART_name {
@@ -44,6 +45,8 @@ extern "C" {
     void CMSIS_SysTick_Timer_init(void); //Инициализация системного таймера
     void Delay_ms(uint32_t Milliseconds); //Функция задержки
     void SysTick_Handler(void); //Прерывания от системного таймера
+    void CMSIS_DWT_Cycle_Counter_init(void); //Запуск счетчика тактов ядра DWT->CYCCNT
+    void CMSIS_SWO_init(uint32_t SWO_Baud, uint32_t Ports); //Вывод трассировки ITM через SWO (PB3)
     void CMSIS_PC13_OUTPUT_Push_Pull_init(void); //Пример настройки ножки PC13 в режим Push-Pull 50 MHz
     void CMSIS_Blink_PC13(uint32_t ms); //Обычный blink
     void CMSIS_PA8_MCO_init(void); //Пример настройки ножки PA8 в выход тактирующего сигнала c MCO
@@ -71,9 +74,11 @@ extern "C" {
     bool CMSIS_I2C_MemWrite(I2C_TypeDef* I2C, uint8_t Adress_Device, uint16_t Adress_data, uint8_t Size_adress, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Функция записи в память по указанному адресу
     bool CMSIS_I2C_MemRead(I2C_TypeDef* I2C, uint8_t Adress_Device, uint16_t Adress_data, uint8_t Size_adress, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Функция чтения из памяти по указанному адресу
     void CMSIS_SPI1_init(void); //Инициализация SPI1
-    bool CMSIS_SPI_Data_Transmit_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Функция отправки данных по SPI
+    bool CMSIS_SPI_Set_Prescaler(SPI_TypeDef* SPI, uint8_t Prescaler, uint32_t Timeout_ms); //Смена делителя SCK (BR[2:0])
+    RAMFUNC bool CMSIS_SPI_Data_Transmit_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Функция отправки данных по SPI
     bool CMSIS_SPI_Data_Transmit_16BIT(SPI_TypeDef* SPI, uint16_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Функция отправки данных по SPI
-    bool CMSIS_SPI_Data_Receive_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms);//Функция приема данных по SPI
+    RAMFUNC bool CMSIS_SPI_Data_Receive_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms);//Функция приема данных по SPI
+    RAMFUNC bool CMSIS_SPI_Data_Exchange_8BIT_cycles(SPI_TypeDef* SPI, const uint8_t* Tx, uint8_t* Rx, uint16_t Size_data, uint32_t Timeout_cycles); //Обмен по SPI с таймаутом по DWT (для прерываний)
     bool CMSIS_SPI_Data_Receive_16BIT(SPI_TypeDef* SPI, uint16_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Функция приема данных по SPI
     bool CMSIS_SPI_Data_Transmit_fast(SPI_TypeDef* SPI, GPIO_TypeDef* GPIO, uint8_t NSS_pin, bool NSS_logic, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Функция передачи данных по SPI(быстрая. CS уже включен в нее)
     bool CMSIS_SPI_Data_Receive_fast(SPI_TypeDef* SPI, GPIO_TypeDef* GPIO, uint8_t NSS_pin, bool NSS_logic, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms); //Функция приема данных по SPI(быстрая. CS уже включен в нее)
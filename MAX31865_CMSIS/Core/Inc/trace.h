@@ -0,0 +1,99 @@
+/**
+ ******************************************************************************
+ *  @file trace.h
+ *  @brief Трассировка событий тракта измерения через ITM/SWO
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Каждое событие - одно 32-битное слово в стимул-порт TRACE_ITM_PORT:
+ *      [31:28] - код события (enum ниже)
+ *      [27:24] - номер канала (датчика)
+ *      [23:0]  - младшие 24 бита Clock_Now() (такты 72 MHz и при смене частоты, clock_manager.h)
+ *  24 бита переполняются раз в 233 мс, поэтому из SysTick раз в
+ *  TRACE_SYNC_PERIOD_MS мс пишется событие TRACE_SYNC - по нему декодер на ПК
+ *  (host/itm_decode.py) восстанавливает полное время без неоднозначности.
+ *
+ *  Запись не блокирует: если FIFO стимул-порта занят, событие отбрасывается
+ *  и увеличивается счетчик Trace_Dropped. Никакого USART и printf.
+ *
+ *  Пока USE_TRACE не определен, TRACE_EVENT() раскрывается в пустой оператор.
+ *
+ *  Запуск: CMSIS_Debug_init(); ...; Trace_Init(); Снимать SWO можно, например,
+ *  OpenOCD: "tpiu config internal swo.bin uart off 72000000 2000000"
+ *  (частота ядра и скорость SWO - как в TRACE_SWO_BAUD), затем
+ *  python3 host/itm_decode.py swo.bin
+ ******************************************************************************
+ */
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stm32f1xx.h>
+#include <stdint.h>
+
+/*----------Включение трассировки----------*/
+//#define USE_TRACE   //Раскомментировать, чтобы собрать с трассировкой ITM/SWO
+/*----------Включение трассировки----------*/
+
+#define TRACE_ITM_PORT      1       //Стимул-порт событий (порт 0 оставлен под текстовый вывод)
+#define TRACE_SWO_BAUD      2000000 //Скорость SWO, бит/с (72MHz / 2MHz = 36 - целое)
+#define TRACE_SYNC_PERIOD_MS 100    //Период события TRACE_SYNC, мс (меньше 233 мс)
+
+//Коды событий (4 бита). Должны совпадать с host/itm_decode.py
+enum {
+	TRACE_SYNC = 0, //Метка времени для восстановления старших бит
+	TRACE_CS_ASSERT = 1, //CS опущен, начало транзакции SPI
+	TRACE_CS_RELEASE = 2, //CS поднят, регистры прочитаны
+	TRACE_DRDY = 3, //Сигнал DRDY от MAX31865 (прерывание)
+	//4 - не используется: SPI к MAX31865 работает без DMA
+	TRACE_CONVERSION_DONE = 5, //Температура пересчитана
+	TRACE_FAULT = 6, //MAX31865 сообщил об ошибке
+	TRACE_ACTUATION = 7 //Новое значение выхода записано (ШИМ нагревателя)
+};
+
+#if defined (USE_TRACE)
+
+#include "clock_manager.h"
+
+extern volatile uint32_t Trace_Dropped; //Сколько событий отброшено из-за занятого FIFO
+
+/*
+ **************************************************************************************************
+ *  @breif Запись события в стимул-порт ITM
+ *  @attention Безопасно из прерываний: проверка FIFO, запись и счетчик отброшенных - с
+ *  запрещенными прерываниями (несколько тактов). Время берется там же, поэтому вытеснившее
+ *  прерывание не вклинится между проверкой и записью, и слова в потоке идут по времени.
+ **************************************************************************************************
+ */
+static inline void Trace_Event(uint32_t Event, uint32_t Channel) {
+	uint32_t Primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t Word = (Event << 28) | ((Channel & 0x0F) << 24) | (Clock_Now() & 0x00FFFFFF);
+	if (ITM->PORT[TRACE_ITM_PORT].u32 == 0) {
+		Trace_Dropped++; //FIFO занят - не ждем
+	} else {
+		ITM->PORT[TRACE_ITM_PORT].u32 = Word;
+	}
+	__set_PRIMASK(Primask);
+}
+
+#define TRACE_EVENT(Event, Channel) Trace_Event((Event), (Channel))
+
+void Trace_Init(void); //Запуск SWO, ITM и DWT->CYCCNT
+
+#else
+
+#define TRACE_EVENT(Event, Channel) (void) 0
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACE_H */
@@ -0,0 +1,196 @@
+/**
+ ******************************************************************************
+ *  @file clock_manager.c
+ *  @brief Смена частоты ядра между пачками измерений: HSE 8 MHz <-> PLL 72 MHz
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. clock_manager.h. Файл пустой, пока не определен USE_CLOCK_SCALING.
+ ******************************************************************************
+ */
+
+#include "clock_manager.h"
+
+#if defined (USE_CLOCK_SCALING)
+
+#include "MAX31865.h"
+#include "trace.h"
+
+extern volatile uint32_t SysTimer_ms; //Время от запуска, мс (см. stm32f103xx_CMSIS.c)
+
+struct Clock_Stats Clock_Stats;
+volatile uint32_t Clock_Base = 0;
+volatile uint32_t Clock_Mark = 0;
+volatile uint32_t Clock_Mult = 1;
+
+static uint32_t Clock_Mode_start_ms; //SysTimer_ms при входе в текущую частоту
+
+/*
+ **************************************************************************************************
+ *  @breif Начало учета: ядро на PLL 72 MHz после CMSIS_RCC_SystemClock_72MHz()
+ **************************************************************************************************
+ */
+void Clock_Init(void) {
+	CMSIS_DWT_Cycle_Counter_init();
+	Clock_Stats = (struct Clock_Stats) { .Mode = CLOCK_PLL_72MHZ };
+	Clock_Base = 0;
+	Clock_Mark = DWT->CYCCNT;
+	Clock_Mult = 1;
+	Clock_Mode_start_ms = SysTimer_ms;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Делитель SPI1 для частоты Hz
+ *  @attention На 72 MHz - подобранный (MAX31865_SPI_Tune()), иначе самый быстрый не выше
+ *  подобранной частоты.
+ **************************************************************************************************
+ */
+static uint8_t Clock_SPI1_Prescaler(uint32_t Hz) {
+	if (Hz == CLOCK_PLL_HZ) {
+		return MAX31865_SPI_Link.Prescaler;
+	}
+	uint32_t Limit = MAX31865_SPI_Link.Frequency ? MAX31865_SPI_Link.Frequency : MAX31865_SPI_MAX_HZ;
+	uint8_t Prescaler = 0;
+	while (Prescaler < 7 && (Hz >> (Prescaler + 1)) > Limit) {
+		Prescaler++;
+	}
+	return Prescaler;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Смена делителя SPI1 при запрещенных прерываниях
+ *  @attention Не CMSIS_SPI_Set_Prescaler(): его таймаут в мс при запрещенных прерываниях не идет.
+ *  Обработчики заканчивают обмен до выхода, так что BSY здесь уже снят; ожидание все равно
+ *  ограничено CLOCK_SPI_BSY_CYCLES тактов.
+ **************************************************************************************************
+ */
+static void Clock_SPI1_Set(uint8_t Prescaler) {
+	uint32_t Start = DWT->CYCCNT;
+	while (READ_BIT(SPI1->SR, SPI_SR_BSY) && (DWT->CYCCNT - Start) < CLOCK_SPI_BSY_CYCLES) ;
+	CLEAR_BIT(SPI1->CR1, SPI_CR1_SPE);
+	MODIFY_REG(SPI1->CR1, SPI_CR1_BR, (Prescaler & 0b111) << SPI_CR1_BR_Pos);
+	SET_BIT(SPI1->CR1, SPI_CR1_SPE);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Пересчет делителей периферии под новую частоту
+ *  @attention При запрещенных прерываниях, сразу после смены SW.
+ *  @param  Hz - новая SYSCLK (= HCLK = PCLK2, PCLK1 <= 36 MHz)
+ **************************************************************************************************
+ */
+static void Clock_Peripherals_Update(uint32_t Hz) {
+	//USART1 на PCLK2: BRR = PCLK / скорость (мантисса и дробь вместе), с округлением
+	USART1->BRR = (Hz + CLOCK_USART1_BAUD / 2) / CLOCK_USART1_BAUD;
+
+	//SPI1 на PCLK2 (при переходе на 72 MHz уже стоит - см. Clock_Set())
+	Clock_SPI1_Set(Clock_SPI1_Prescaler(Hz));
+
+	//TIM3: на 72 MHz PCLK1 = 36 MHz и таймер x2, на 8 MHz PCLK1 = 8 MHz и таймер x1 - в обоих случаях Hz
+	TIM3->PSC = Hz / CLOCK_TIM3_HZ - 1;
+
+#if defined (USE_TRACE)
+	TPI->ACPR = Hz / TRACE_SWO_BAUD - 1;
+#endif
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Переключение частоты ядра
+ *  @attention Только из основного цикла. Перед переключением дожидается конца передачи USART1
+ *  (байт на 9600 - до 1 мс). Прерывания запрещены от смены SW до перенастройки SysTick и
+ *  периферии (USART1, SPI1, TIM3, SWO) - обработчики видят только согласованное состояние.
+ *  @param  Mode - CLOCK_HSE_8MHZ или CLOCK_PLL_72MHZ
+ **************************************************************************************************
+ */
+void Clock_Set(uint8_t Mode) {
+	if (Mode == Clock_Stats.Mode) {
+		return;
+	}
+	while (!READ_BIT(USART1->SR, USART_SR_TC)) ; //Байт на линии не должен поменять скорость посередине
+
+	uint32_t Start = DWT->CYCCNT;
+	uint32_t Us;
+	uint32_t Hz;
+
+	__disable_irq();
+	if (Mode == CLOCK_HSE_8MHZ) {
+		MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_HSE);
+		while (READ_BIT(RCC->CFGR, RCC_CFGR_SWS) != RCC_CFGR_SWS_HSE) ;
+		Us = (DWT->CYCCNT - Start) / (CLOCK_PLL_HZ / 1000000); //До смены - такты 72 MHz
+		Start = DWT->CYCCNT;
+		MODIFY_REG(RCC->CFGR, RCC_CFGR_PPRE1, RCC_CFGR_PPRE1_DIV1); //PCLK1 = 8 MHz
+		MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, 0b000 << FLASH_ACR_LATENCY_Pos); //Zero wait state, SYSCLK <= 24 MHz
+		CLEAR_BIT(RCC->CR, RCC_CR_PLLON); //PLL не нужен - экономия
+		Hz = CLOCK_HSE_HZ;
+	} else {
+		Clock_SPI1_Set(Clock_SPI1_Prescaler(CLOCK_PLL_HZ)); //До переключения: на 8 MHz этот делитель медленнее, на 72 MHz - в пределе MAX31865
+		SET_BIT(RCC->CR, RCC_CR_PLLON); //Настройки PLL (источник HSE, x9) в RCC_CFGR сохранились
+		while (READ_BIT(RCC->CR, RCC_CR_PLLRDY) == 0) ;
+		MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, 0b010 << FLASH_ACR_LATENCY_Pos); //Two wait states - до переключения
+		MODIFY_REG(RCC->CFGR, RCC_CFGR_PPRE1, RCC_CFGR_PPRE1_DIV2); //PCLK1 max 36 MHz
+		MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+		while (READ_BIT(RCC->CFGR, RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) ;
+		Us = (DWT->CYCCNT - Start) / (CLOCK_HSE_HZ / 1000000); //Запуск PLL - такты 8 MHz
+		Start = DWT->CYCCNT;
+		Hz = CLOCK_PLL_HZ;
+	}
+
+	//По-прежнему 1 мс. Запись VAL только обнуляет счетчик, поэтому остаток текущей мс
+	//(в тактах новой частоты) идет через LOAD, а полный период ставится после перезагрузки
+	uint32_t Remaining = (uint32_t) ((uint64_t) SysTick->VAL * (Hz / 1000) / (SysTick->LOAD + 1));
+	if (Remaining < CLOCK_SYSTICK_REMAINING_MIN) {
+		Remaining = CLOCK_SYSTICK_REMAINING_MIN;
+	}
+	SysTick->LOAD = Remaining;
+	SysTick->VAL = 0;
+	while (SysTick->VAL == 0) ; //Перезагрузка из LOAD - на следующем такте
+	SysTick->LOAD = Hz / 1000 - 1; //Со следующего периода
+
+	uint32_t Mark = DWT->CYCCNT;
+	Clock_Base = Clock_Base + (Mark - Clock_Mark) * Clock_Mult;
+	Clock_Mark = Mark;
+	Clock_Mult = CLOCK_PLL_HZ / Hz;
+	Clock_Peripherals_Update(Hz);
+	__enable_irq();
+
+	Us += (DWT->CYCCNT - Start) / (Hz / 1000000);
+
+	uint32_t Now_ms = SysTimer_ms;
+	Clock_Stats.Time_ms[Clock_Stats.Mode] += Now_ms - Clock_Mode_start_ms;
+	Clock_Mode_start_ms = Now_ms;
+	Clock_Stats.Mode = Mode;
+	Clock_Stats.Switches++;
+	if (Mode == CLOCK_PLL_72MHZ) {
+		if (Us > Clock_Stats.Up_us_max) {
+			Clock_Stats.Up_us_max = Us;
+		}
+	} else if (Us > Clock_Stats.Down_us_max) {
+		Clock_Stats.Down_us_max = Us;
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Оценка энергии, потребленной ядром с Clock_Init()
+ *  @attention Время на частотах * типовой ток * напряжение. Энергия на измерение - это
+ *  разность двух оценок, деленная на разность номеров последовательности (reading.h).
+ *  @retval мкДж
+ **************************************************************************************************
+ */
+uint32_t Clock_Energy_uJ(void) {
+	uint32_t Time_ms[CLOCK_MODES];
+	for (uint8_t Mode = 0; Mode < CLOCK_MODES; Mode++) {
+		Time_ms[Mode] = Clock_Stats.Time_ms[Mode];
+	}
+	Time_ms[Clock_Stats.Mode] += SysTimer_ms - Clock_Mode_start_ms; //Текущий отрезок
+
+	//мс * мкА * мВ = 1e-12 Дж
+	uint64_t pJ = (uint64_t) Time_ms[CLOCK_HSE_8MHZ] * CLOCK_RUN_UA_8MHZ * CLOCK_SUPPLY_MV + (uint64_t) Time_ms[CLOCK_PLL_72MHZ] * CLOCK_RUN_UA_72MHZ * CLOCK_SUPPLY_MV;
+	return (uint32_t) (pJ / 1000000);
+}
+
+#endif
@@ -1,32 +1,100 @@
 #include "main.h"
 #include "MAX31865.h"
+#include "heater_control.h"
+#include "profiler.h"
+#include "trace.h"
+#include "telemetry.h"
+#include "mem_usage.h"
+#include "trip.h"
+#include "clock_manager.h"
+#include "crc32.h"
+#include "i2c_dma.h"
+#include "pwm_sync.h"
 
 /*-----------------------------------------Глобальные переменные---------------------------------------------*/
-extern float MAX31865_PT100_R; //Глобальная переменная, определяющая сопротивление датчика PT100
-extern float MAX31865_PT100_T; //Глобальная переменная, определяющая температуру датчика PT100
-extern float MAX31865_Correction_additive; //Калибровка смещения
-extern float MAX31865_Correction_multiplicative; //Калибровка наклона
-extern bool MAX31865_Sensor_Error; //Глобальная переменная, определяющая неисправность датчика PT100
+struct Reading PT100_Reading; //Последнее измерение (другим контекстам - через Reading_Get(0, ...))
 /*-----------------------------------------Глобальные переменные---------------------------------------------*/
 
 
 int main(void) {
+    Mem_Usage_Stack_Paint(); //Заполнение стека шаблоном для замера глубины (команда "mem")
     CMSIS_Debug_init();
     CMSIS_RCC_SystemClock_72MHz();
     CMSIS_SysTick_Timer_init();
     CMSIS_SPI1_init();
+    CMSIS_USART1_Init(); //Телеметрия (команды см. telemetry.h)
+    CRC32_init(); //Блок CRC для кадров, журналов и записей калибровки (crc32.h)
+#if defined (USE_PROFILER)
+    Profiler_Init();
+#endif
+#if defined (USE_TRACE)
+    Trace_Init(); //SWO и ITM для TRACE_EVENT() (разбор - host/itm_decode.py)
+#endif
+#if defined (USE_I2C_DMA)
+    I2C_DMA_init(); //I2C1 (PB6/PB7) в фоне: запросы через I2C_DMA_Submit(), опрос датчика не ждет
+#endif
+#if defined (USE_CLOCK_SCALING)
+    Clock_Init(); //Дальше ожидание в цикле идет на 8 MHz (команда "clock")
+#endif
     
     //PA4 - NSS
     SET_BIT(RCC->APB2ENR, RCC_APB2ENR_IOPAEN); //Запуск тактирования порта A
     MODIFY_REG(GPIOA->CRL, GPIO_CRL_MODE4, 0b10 << GPIO_CRL_MODE4_Pos); //Настройка GPIOA Pin 4 на выход со максимальной скоростью в 50 MHz
     MODIFY_REG(GPIOA->CRL, GPIO_CRL_CNF4, 0b00 << GPIO_CRL_CNF4_Pos); //Настройка GPIOA Pin 4 на выход в режиме Push-Pull
     
+    Channel_Table_Init();
+    Channel_Set_Calibration(0, 1.0f, 0.0f, MAX31865_R_REF); //Калибровка наклона и смещения (R = R_raw * mult + add)
     MAX31865_Init(SPI1, 3); //3 проводное подключение
+    MAX31865_SPI_Tune(SPI1); //Самая быстрая надежная частота SCK для этой линии (команда "spi")
+    
+    Heater_Control_init(); //ШИМ нагревателя на PB4 (TIM3 CH1)
+    PID_Set_Automatic(&Heater_PID, (int32_t) (MAX31865_Get_Temperature(MAX31865_Get_Resistance(SPI1)) * 100.0));
+    
+    Trend_Table[0].Decimation = 10; //Точка окна - 10 выборок (2 с), окно 32 точки - около минуты
+    Trend_Table[0].Ticks_per_ms = CLOCK_NOW_PER_US * 1000; //Timestamp - Clock_Now() (верно и при USE_CLOCK_SCALING)
+    Pipeline_Trend_Limits_degC(&Trend_Table[0], 0, -50.0f, 90.0f, 120); //Предварительная авария за 2 минуты до выхода из -50..90 °C
+    Trend_Table[0].Enabled = true;
+    
+#if defined (USE_TRIP)
+    Trip_Table[0] = (struct Trip_Channel) { .Delay_on = 2, .Latching = true, .On_fault = true, .Enabled = true };
+    Trip_Set_Limits_degC(0, -50.0f, 90.0f, 2.0f); //Авария вне -50..90 °C, возврат на 2 °C внутри
+    Trip_init(); //С этого момента SPI1 к MAX31865 читает только обработчик DRDY
+#elif defined (USE_PWM_SYNC)
+    PWM_Sync_init(3, PWM_SYNC_PHASE_OFF_MIDDLE); //1-shot в середине паузы ШИМ нагревателя
+#endif
     
 	while (1) {
     	
-    	MAX31865_PT100_R = (MAX31865_Get_Resistance(SPI1) * MAX31865_Correction_multiplicative) + MAX31865_Correction_additive; //Значение сопротивления датчика PT100
-    	MAX31865_PT100_T = MAX31865_Get_Temperature(MAX31865_PT100_R); //Рассчет температуры датчика PT100
+    	bool Sampled = false; //Новое измерение в этом проходе (регулятор - только по нему)
+    	PROFILER_BEGIN(PROFILER_READ_AND_CONVERT);
+#if defined (USE_TRIP)
+    	while (Trip_Take_Sample(&PT100_Reading)) {
+    		MAX31865_Publish(0, &PT100_Reading); //Код уже прочитан и проверен в прерывании DRDY
+    		Sampled = true;
+    	}
+#elif defined (USE_PWM_SYNC)
+    	if (PWM_Sync_Take_Sample(&PT100_Reading)) {
+    		MAX31865_Publish(0, &PT100_Reading); //Преобразование запущено в фазе ШИМ
+    		Sampled = true;
+    	}
+#else
+    	MAX31865_Measure(SPI1, 0, &PT100_Reading); //Код, сопротивление, температура и статус датчика PT100
+    	Sampled = true;
+#endif
+    	PROFILER_END(PROFILER_READ_AND_CONVERT);
+    	if (Sampled) {
+    		Heater_Control_Update(&PT100_Reading); //Шаг регулятора нагревателя по самому новому измерению (при ошибке датчика - выключен)
+    	}
+    	Telemetry_Poll(); //Ответ на команды по USART1
+#if defined (USE_I2C_DMA)
+    	I2C_DMA_Poll(); //Снятие зависших запросов I2C1
+#endif
+#if defined (USE_CLOCK_SCALING)
+    	Clock_Set(CLOCK_HSE_8MHZ);
+    	Delay_ms(200);
+    	Clock_Set(CLOCK_PLL_72MHZ); //Пересчет и телеметрия - на полной частоте
+#else
     	Delay_ms(200);
+#endif
 	}
 }
\ No newline at end of file
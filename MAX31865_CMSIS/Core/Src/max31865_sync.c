@@ -0,0 +1,149 @@
+/**
+ ******************************************************************************
+ *  @file max31865_sync.c
+ *  @brief Синхронный опрос нескольких MAX31865 (1-shot) с измерением разброса
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. max31865_sync.h
+ ******************************************************************************
+ */
+
+#include "max31865_sync.h"
+#include "clock_manager.h"
+
+struct MAX31865_Snapshot MAX31865_Sync_Last;
+
+static const struct MAX31865_CS* MAX31865_Sync_CS; //Таблица ножек CS (CHANNEL_COUNT штук)
+static uint8_t MAX31865_Sync_Config; //Конфигурация без бита 1-shot: VBIAS, провода, 50 Гц
+
+#define MAX31865_SYNC_CS_LOW(Channel)  MAX31865_Sync_CS[Channel].Port->BSRR = (1UL << (MAX31865_Sync_CS[Channel].Pin + 16))
+#define MAX31865_SYNC_CS_HIGH(Channel) MAX31865_Sync_CS[Channel].Port->BSRR = (1UL << MAX31865_Sync_CS[Channel].Pin)
+
+/*
+ **************************************************************************************************
+ *  @breif Настройка ножек CS и перевод всех каналов в режим 1-shot
+ *  @attention Тактирование портов CS должно быть включено. Таблица должна жить все время работы.
+ *  @param  *SPI - шина SPI
+ *  @param  *CS_table - ножки CS каналов 0..CHANNEL_COUNT-1
+ *  @param  num_wires - тип подключения датчиков 2, 3 или 4 проводное
+ **************************************************************************************************
+ */
+void MAX31865_Sync_Init(SPI_TypeDef* SPI, const struct MAX31865_CS* CS_table, uint8_t num_wires) {
+	CMSIS_DWT_Cycle_Counter_init(); //Предел записи 1-shot - по тактам (MAX31865_Sync_Trigger())
+	MAX31865_Sync_CS = CS_table;
+	MAX31865_Sync_Config = 0x80 | 0x01; //VBIAS вкл., автопреобразование выкл., фильтр 50 Гц
+	if (num_wires == 3) {
+		MAX31865_Sync_Config |= 0x10;
+	}
+
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		volatile uint32_t* CR = (CS_table[Channel].Pin < 8) ? &CS_table[Channel].Port->CRL : &CS_table[Channel].Port->CRH;
+		uint32_t Shift = (CS_table[Channel].Pin % 8) * 4;
+		MAX31865_SYNC_CS_HIGH(Channel);
+		MODIFY_REG(*CR, 0xFUL << Shift, 0b0011UL << Shift); //Выход Push-Pull 50 MHz
+
+		uint8_t Write[2] = { 0x80, MAX31865_Sync_Config | 0x02 }; //Заодно сброс ошибок
+		MAX31865_SYNC_CS_LOW(Channel);
+		CMSIS_SPI_Data_Transmit_8BIT(SPI, Write, 2, 100);
+		MAX31865_SYNC_CS_HIGH(Channel);
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запуск 1-shot во всех каналах одной плотной последовательностью
+ *  @attention Прерывания запрещены на время последовательности (2 байта SPI на канал).
+ *  Таймаут в мс при этом не идет (счетчик уменьшается в SysTick), поэтому запись ограничена
+ *  по тактам DWT (MAX31865_SYNC_SPI_TIMEOUT_CYCLES). Канал, запись которому не прошла,
+ *  отмечается в Triggered[] - MAX31865_Sync_Collect() его не читает, а снимок будет не Valid.
+ *  VBIAS включен постоянно с MAX31865_Sync_Init(), поэтому ждать его установления не нужно.
+ *  @param  *SPI - шина SPI
+ *  @param  *Snapshot - сюда записываются время первого фронта, смещения каналов и разброс
+ **************************************************************************************************
+ */
+void MAX31865_Sync_Trigger(SPI_TypeDef* SPI, struct MAX31865_Snapshot* Snapshot) {
+	uint8_t Write[2] = { 0x80, MAX31865_Sync_Config | 0x20 }; //Бит 1-shot
+	uint8_t Rx[2];
+	uint32_t Edge[CHANNEL_COUNT];
+
+	__disable_irq();
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		MAX31865_SYNC_CS_LOW(Channel);
+		Snapshot->Triggered[Channel] = CMSIS_SPI_Data_Exchange_8BIT_cycles(SPI, Write, Rx, 2, MAX31865_SYNC_SPI_TIMEOUT_CYCLES);
+		MAX31865_SYNC_CS_HIGH(Channel);
+		Edge[Channel] = Clock_Now(); //Преобразование стартует по фронту CS
+	}
+	__enable_irq();
+
+	Snapshot->Timestamp = Edge[0];
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		Snapshot->Trigger_offset[Channel] = Edge[Channel] - Edge[0];
+	}
+	Snapshot->Skew_cycles = Edge[CHANNEL_COUNT - 1] - Edge[0];
+	Snapshot->Valid = false;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Чтение результатов всех каналов и публикация (reading.h, fault_log.h)
+ *  @attention Вызывать не раньше чем через MAX31865_SYNC_CONVERSION_MS после MAX31865_Sync_Trigger().
+ *  Время измерения в записи канала - момент его запуска, а не чтения.
+ *  Ошибка канала сбрасывается сразу после чтения, как в MAX31865_Get_Code(), - иначе она
+ *  защелкнута и попадает в каждый следующий снимок. Отдельной записью, а не вместе с 1-shot:
+ *  сброс ошибок (D1) срабатывает только при D5 = 0 (datasheet, Configuration Register).
+ *  Канал, которому не прошел запуск (Triggered[] = false), не читается и не публикуется:
+ *  в его регистрах предыдущее преобразование.
+ *  @param  *SPI - шина SPI
+ *  @param  *Snapshot - снимок после MAX31865_Sync_Trigger()
+ *  @retval  true - все каналы запущены и прочитаны
+ **************************************************************************************************
+ */
+bool MAX31865_Sync_Collect(SPI_TypeDef* SPI, struct MAX31865_Snapshot* Snapshot) {
+	uint8_t Address = 0x01;
+	uint8_t Rx[7];
+	bool Status = true;
+
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		if (!Snapshot->Triggered[Channel]) {
+			Status = false;
+			continue;
+		}
+		MAX31865_SYNC_CS_LOW(Channel);
+		bool Ok = CMSIS_SPI_Data_Transmit_8BIT(SPI, &Address, 1, 100) && CMSIS_SPI_Data_Receive_8BIT(SPI, Rx, 7, 100);
+		MAX31865_SYNC_CS_HIGH(Channel);
+		if (!Ok) {
+			Status = false;
+			continue;
+		}
+		Snapshot->Code[Channel] = ((Rx[0] << 8) | Rx[1]) >> 1;
+		Snapshot->Status[Channel] = Rx[6];
+		if (Rx[6]) {
+			uint8_t Write[2] = { 0x80, MAX31865_Sync_Config | 0x02 }; //Сброс ошибки, 1-shot не трогаем
+			MAX31865_SYNC_CS_LOW(Channel);
+			CMSIS_SPI_Data_Transmit_8BIT(SPI, Write, 2, 100);
+			MAX31865_SYNC_CS_HIGH(Channel);
+		}
+
+		struct Reading Reading;
+		Reading.Code = Snapshot->Code[Channel];
+		Reading.Status = Snapshot->Status[Channel];
+		Reading.Timestamp = Snapshot->Timestamp + Snapshot->Trigger_offset[Channel];
+		MAX31865_Publish(Channel, &Reading);
+	}
+	Snapshot->Valid = Status;
+	MAX31865_Sync_Last = *Snapshot;
+	return Status;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Синхронный снимок целиком (блокирующий, ~63 мс)
+ **************************************************************************************************
+ */
+bool MAX31865_Sync_Snapshot(SPI_TypeDef* SPI, struct MAX31865_Snapshot* Snapshot) {
+	MAX31865_Sync_Trigger(SPI, Snapshot);
+	Delay_ms(MAX31865_SYNC_CONVERSION_MS);
+	return MAX31865_Sync_Collect(SPI, Snapshot);
+}
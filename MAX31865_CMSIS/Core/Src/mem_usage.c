@@ -0,0 +1,88 @@
+/**
+ ******************************************************************************
+ *  @file mem_usage.c
+ *  @brief Контроль использования ОЗУ: глубина стека и куча _sbrk
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. mem_usage.h
+ ******************************************************************************
+ */
+
+#include "mem_usage.h"
+#include <stm32f1xx.h>
+#include <stddef.h>
+
+//Символы скрипта компоновщика
+extern uint8_t _sramfunc;
+extern uint8_t _ebss;
+extern uint8_t _end;
+extern uint8_t _estack;
+extern uint8_t _Min_Stack_Size;
+
+//Учет кучи в sysmem.c
+extern uint32_t __sbrk_heap_peak;
+extern uint32_t __sbrk_heap_failures;
+extern void* _sbrk(ptrdiff_t incr);
+
+static uint32_t* Mem_Usage_paint_top = 0; //Верхняя граница заполнения (0 - заполнения не было)
+
+/*
+ **************************************************************************************************
+ *  @breif Нижняя граница стека для поиска: конец кучи на пике, выровненный на слово
+ **************************************************************************************************
+ */
+static uint32_t* Mem_Usage_Stack_Bottom(void) {
+	return (uint32_t*) (((uint32_t) &_end + __sbrk_heap_peak + 3) & ~3UL);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Заполнение свободного ОЗУ под стеком шаблоном
+ *  @attention Вызывать первой строкой main(), пока стек почти пуст.
+ *  Заполняется от конца кучи до текущей вершины стека минус MEM_USAGE_PAINT_MARGIN.
+ **************************************************************************************************
+ */
+void Mem_Usage_Stack_Paint(void) {
+	uint32_t* Top = (uint32_t*) ((__get_MSP() - MEM_USAGE_PAINT_MARGIN) & ~3UL);
+	for (volatile uint32_t* p = Mem_Usage_Stack_Bottom(); p < Top; p++) {
+		*p = MEM_USAGE_STACK_PATTERN;
+	}
+	Mem_Usage_paint_top = Top;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Максимальная глубина стека с момента заполнения
+ *  @attention Поиск линейный (до нескольких тысяч слов) - вызывать по запросу.
+ *  @retval Байт от _estack до самого нижнего затертого слова. 0 - заполнения не было.
+ **************************************************************************************************
+ */
+uint32_t Mem_Usage_Stack_Peak(void) {
+	if (Mem_Usage_paint_top == 0) {
+		return 0;
+	}
+	const volatile uint32_t* p = Mem_Usage_Stack_Bottom();
+	while (p < Mem_Usage_paint_top && *p == MEM_USAGE_STACK_PATTERN) {
+		p++;
+	}
+	return (uint32_t) &_estack - (uint32_t) p;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Снимок использования ОЗУ
+ **************************************************************************************************
+ */
+void Mem_Usage_Get(struct Mem_Usage* Usage) {
+	uint32_t Ram_free = (uint32_t) &_estack - (uint32_t) &_end; //Под кучу и стек вместе
+
+	Usage->Static = (uint32_t) &_ebss - (uint32_t) &_sramfunc;
+	Usage->Heap = (uint32_t) _sbrk(0) - (uint32_t) &_end;
+	Usage->Heap_peak = __sbrk_heap_peak;
+	Usage->Heap_failures = __sbrk_heap_failures;
+	Usage->Stack_reserved = (uint32_t) &_Min_Stack_Size;
+	Usage->Stack_peak = Mem_Usage_Stack_Peak();
+	Usage->Free_min = Ram_free - Usage->Heap_peak - (Usage->Stack_peak ? Usage->Stack_peak : (uint32_t) &_estack - __get_MSP());
+}
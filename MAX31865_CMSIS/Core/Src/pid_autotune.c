@@ -0,0 +1,165 @@
+/**
+ ******************************************************************************
+ *  @file pid_autotune.c
+ *  @brief Автонастройка ПИД-регулятора методом релейной обратной связи (Åström–Hägglund)
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание метода и единиц см. pid_autotune.h
+ *  Плавающая точка используется только один раз - при расчете коэффициентов по окончании.
+ ******************************************************************************
+ */
+
+#include "pid_autotune.h"
+#include <math.h>
+
+#define PID_AUTOTUNE_SKIP_CYCLES 2 //Первые периоды не учитываем (объект еще выходит на колебания)
+
+/*
+ **************************************************************************************************
+ *  @breif Перевод float в Q16.16 с насыщением
+ **************************************************************************************************
+ */
+static int32_t PID_Autotune_To_Q16(float Value) {
+	float Q = Value * 65536.0f;
+	if (Q >= 2147483647.0f) {
+		return INT32_MAX;
+	}
+	if (Q <= 0.0f) {
+		return 0;
+	}
+	return (int32_t) (Q + 0.5f);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Расчет Ku, Tu и коэффициентов регулятора по снятым колебаниям
+ **************************************************************************************************
+ */
+static void PID_Autotune_Calculate(struct PID_Autotune* AT) {
+	uint32_t Count = PID_AUTOTUNE_CYCLES - PID_AUTOTUNE_SKIP_CYCLES;
+	float a = (float) AT->Amplitude_sum / (float) (2 * Count); //Амплитуда = половина размаха
+	float eps = (float) AT->Hysteresis;
+
+	AT->Tu_ms = AT->Period_sum_ms / Count;
+	AT->Amplitude = (int32_t) (a + 0.5f);
+	if (a <= eps || AT->Tu_ms == 0 || AT->Sample_period_ms == 0) {
+		AT->State = PID_AUTOTUNE_FAILED; //Колебания не больше гистерезиса - шум, а не автоколебания
+		return;
+	}
+
+	AT->Ku = (4.0f * (float) AT->Output_step) / (3.14159265f * sqrtf(a * a - eps * eps));
+
+	float Kp, Ti_ms, Td_ms;
+	if (AT->Rule == PID_AUTOTUNE_TYREUS_LUYBEN) {
+		Kp = AT->Ku / 2.2f;
+		Ti_ms = 2.2f * (float) AT->Tu_ms;
+		Td_ms = (float) AT->Tu_ms / 6.3f;
+	} else {
+		Kp = 0.6f * AT->Ku;
+		Ti_ms = 0.5f * (float) AT->Tu_ms;
+		Td_ms = 0.125f * (float) AT->Tu_ms;
+	}
+
+	//Ki и Kd в pid_controller - на один шаг дискретизации
+	AT->Kp = PID_Autotune_To_Q16(Kp);
+	AT->Ki = PID_Autotune_To_Q16(Kp * (float) AT->Sample_period_ms / Ti_ms);
+	AT->Kd = PID_Autotune_To_Q16(Kp * Td_ms / (float) AT->Sample_period_ms);
+	AT->State = PID_AUTOTUNE_DONE;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запуск автонастройки
+ *  @attention Перед запуском заполните параметры структуры (Setpoint, Hysteresis, Output_bias,
+ *  Output_step, Sample_period_ms, Timeout_ms, Rule). Output_bias +- Output_step должны
+ *  лежать в диапазоне выхода, а Output_bias + Output_step - быть достаточным, чтобы
+ *  поднять температуру выше уставки.
+ *  @param  *AT - структура автонастройки
+ *  @param  Time_ms - текущее время, мс (например SysTimer_ms)
+ **************************************************************************************************
+ */
+void PID_Autotune_Start(struct PID_Autotune* AT, uint32_t Time_ms) {
+	AT->State = PID_AUTOTUNE_RELAY;
+	AT->Relay_high = true;
+	AT->Cycles = 0;
+	AT->Start_ms = Time_ms;
+	AT->Last_rise_ms = Time_ms;
+	AT->Peak_max = INT32_MIN;
+	AT->Peak_min = INT32_MAX;
+	AT->Period_sum_ms = 0;
+	AT->Amplitude_sum = 0;
+	AT->Tu_ms = 0;
+	AT->Amplitude = 0;
+	AT->Ku = 0.0f;
+	AT->Kp = 0;
+	AT->Ki = 0;
+	AT->Kd = 0;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Шаг автонастройки
+ *  @attention Вызывается на каждое новое измерение, не блокирует.
+ *  Вне состояния PID_AUTOTUNE_RELAY возвращает нижнее значение реле (безопасная сторона).
+ *  @param  *AT - структура автонастройки
+ *  @param  Measurement - измерение, 0.01 °C
+ *  @param  Time_ms - текущее время, мс
+ *  @retval Возвращает выход, который нужно подать на объект
+ **************************************************************************************************
+ */
+int32_t PID_Autotune_Step(struct PID_Autotune* AT, int32_t Measurement, uint32_t Time_ms) {
+	if (AT->State != PID_AUTOTUNE_RELAY) {
+		return AT->Output_bias - AT->Output_step;
+	}
+	if ((uint32_t) (Time_ms - AT->Start_ms) > AT->Timeout_ms) {
+		AT->State = PID_AUTOTUNE_FAILED;
+		return AT->Output_bias - AT->Output_step;
+	}
+
+	if (Measurement > AT->Peak_max) {
+		AT->Peak_max = Measurement;
+	}
+	if (Measurement < AT->Peak_min) {
+		AT->Peak_min = Measurement;
+	}
+
+	if (AT->Relay_high && Measurement > AT->Setpoint + AT->Hysteresis) {
+		AT->Relay_high = false;
+	} else if (!AT->Relay_high && Measurement < AT->Setpoint - AT->Hysteresis) {
+		AT->Relay_high = true;
+		//Переключение реле вверх - граница периода колебаний
+		if (AT->Cycles > PID_AUTOTUNE_SKIP_CYCLES) {
+			AT->Period_sum_ms += Time_ms - AT->Last_rise_ms;
+			AT->Amplitude_sum += (int64_t) AT->Peak_max - AT->Peak_min;
+		}
+		AT->Last_rise_ms = Time_ms;
+		AT->Peak_max = Measurement;
+		AT->Peak_min = Measurement;
+		if (AT->Cycles++ == PID_AUTOTUNE_CYCLES) {
+			PID_Autotune_Calculate(AT);
+			return AT->Output_bias - AT->Output_step;
+		}
+	}
+
+	return AT->Relay_high ? AT->Output_bias + AT->Output_step : AT->Output_bias - AT->Output_step;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Перенос результата автонастройки в регулятор
+ *  @attention Регулятор переводится в автомат безударно, стартуя с выхода Output_bias.
+ *  @param  *AT - структура автонастройки (State == PID_AUTOTUNE_DONE)
+ *  @param  *PID - регулятор
+ *  @param  Measurement - текущее измерение, 0.01 °C
+ **************************************************************************************************
+ */
+void PID_Autotune_Apply(const struct PID_Autotune* AT, struct PID_Controller* PID, int32_t Measurement) {
+	if (AT->State != PID_AUTOTUNE_DONE) {
+		return;
+	}
+	PID_Set_Tunings(PID, AT->Kp, AT->Ki, AT->Kd);
+	PID_Set_Manual(PID, AT->Output_bias);
+	PID_Set_Automatic(PID, Measurement);
+}
@@ -0,0 +1,176 @@
+/**
+ ******************************************************************************
+ *  @file pwm_sync.c
+ *  @brief Запуск 1-shot преобразования MAX31865 в заданной фазе ШИМ нагревателя
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. pwm_sync.h. Файл пустой, пока не определен USE_PWM_SYNC.
+ ******************************************************************************
+ */
+
+#include "pwm_sync.h"
+
+#if defined (USE_PWM_SYNC) && defined (USE_CMSIS)
+
+#include "clock_manager.h"
+#include "trip.h"
+#include "trace.h"
+
+#if defined (USE_TRIP)
+#error "USE_PWM_SYNC and USE_TRIP both read SPI1 from interrupts - enable only one"
+#endif
+
+#define PWM_SYNC_CYCLES_PER_MS 72000 //Такты Clock_Now() в мс
+
+struct PWM_Sync_Stats PWM_Sync_Stats;
+
+static uint8_t PWM_Sync_Config; //Регистр конфигурации MAX31865 без бита 1-shot
+static volatile uint16_t PWM_Sync_Phase = PWM_SYNC_PHASE_OFF_MIDDLE;
+static volatile bool PWM_Sync_Converting = false; //false - запуск поставлен и ждет фазы (SPI1 у прерывания)
+static volatile uint32_t PWM_Sync_Edge; //Clock_Now() на фронте CS запуска
+
+/*
+ **************************************************************************************************
+ *  @breif Постановка запуска на ближайшее совпадение фазы
+ **************************************************************************************************
+ */
+static void PWM_Sync_Arm(void) {
+	uint16_t Phase = PWM_Sync_Phase;
+	if (Phase == PWM_SYNC_PHASE_OFF_MIDDLE) {
+		uint16_t On = (uint16_t) TIM3->CCR1;
+		Phase = (On >= HEATER_PWM_PERIOD) ? HEATER_PWM_PERIOD - 1 : On + (HEATER_PWM_PERIOD - On) / 2; //100% - паузы нет, запуск в конце периода
+	} else if (Phase >= HEATER_PWM_PERIOD) {
+		Phase = HEATER_PWM_PERIOD - 1;
+	}
+	TIM3->CCR2 = Phase; //Без preload - действует сразу
+	PWM_Sync_Stats.Phase = Phase;
+
+	PWM_Sync_Converting = false;
+	__DMB(); //SPI1 передается прерыванию после записи состояния
+	CLEAR_BIT(TIM3->SR, TIM_SR_CC2IF); //Флаг ставится каждый период и без прерывания - старый сбросить
+	SET_BIT(TIM3->DIER, TIM_DIER_CC2IE);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Перевод MAX31865 в 1-shot и запуск по фазе ШИМ
+ *  @attention После Heater_Control_init() (TIM3 уже считает). С этого момента SPI1 к MAX31865
+ *  читается только через PWM_Sync_Take_Sample().
+ *  @param  num_wires - схема подключения датчика (2, 3, 4)
+ *  @param  Phase - такты TIM3 от начала периода ШИМ или PWM_SYNC_PHASE_OFF_MIDDLE
+ **************************************************************************************************
+ */
+void PWM_Sync_init(uint8_t num_wires, uint16_t Phase) {
+	PWM_Sync_Config = 0x80 | 0x01 | (num_wires == 3 ? 0x10 : 0x00); //VBIAS вкл. постоянно, фильтр 50 Гц, без авто
+	uint8_t Write[2] = { 0x80, PWM_Sync_Config | 0x02 }; //Заодно сброс ошибок
+	NSS_ON;
+	CMSIS_SPI_Data_Transmit_8BIT(SPI1, Write, 2, 100);
+	NSS_OFF;
+
+	//TIM3 CH2 - сравнение без вывода на ножку (CC2E = 0)
+	MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_CC2S_Msk, 0b00 << TIM_CCMR1_CC2S_Pos); //CC2 channel is configured as output
+	MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_OC2M_Msk, 0b000 << TIM_CCMR1_OC2M_Pos); //Frozen - только флаг CC2IF
+	CLEAR_BIT(TIM3->CCMR1, TIM_CCMR1_OC2PE); //Preload disable - новая фаза сразу
+	CLEAR_BIT(TIM3->CCER, TIM_CCER_CC2E);
+
+	PWM_Sync_Phase = Phase;
+	NVIC_SetPriority(TIM3_IRQn, PWM_SYNC_IRQ_PRIORITY);
+	NVIC_EnableIRQ(TIM3_IRQn);
+	PWM_Sync_Arm();
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Смена фазы запуска (со следующей постановки)
+ *  @param  Phase - такты TIM3 от начала периода ШИМ или PWM_SYNC_PHASE_OFF_MIDDLE
+ **************************************************************************************************
+ */
+void PWM_Sync_Set_Phase(uint16_t Phase) {
+	PWM_Sync_Phase = Phase;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Забрать готовую выборку и поставить следующий запуск
+ *  @attention Из основного цикла. Не ждет: пока преобразование идет, сразу false.
+ *  @param  *Reading - заполняются Code, Status, Timestamp (фронт запуска)
+ *  @retval true - есть новая выборка
+ **************************************************************************************************
+ */
+bool PWM_Sync_Take_Sample(struct Reading* Reading) {
+	if (!PWM_Sync_Converting || Clock_Now() - PWM_Sync_Edge < PWM_SYNC_CONVERSION_MS * PWM_SYNC_CYCLES_PER_MS) {
+		return false;
+	}
+	MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_OC1M_Msk, PWM_SYNC_OC1M_PWM << TIM_CCMR1_OC1M_Pos); //Преобразование кончилось - нагреватель снова по CCR1
+
+	uint8_t Address = 0x01;
+	uint8_t Rx[7];
+	NSS_ON;
+	TRACE_EVENT(TRACE_CS_ASSERT, 0);
+	CMSIS_SPI_Data_Transmit_8BIT(SPI1, &Address, 1, 10);
+	CMSIS_SPI_Data_Receive_8BIT(SPI1, Rx, 7, 10);
+	NSS_OFF;
+	TRACE_EVENT(TRACE_CS_RELEASE, 0);
+	MAX31865_Sample_timestamp = Clock_Now(); //Окончание чтения последнего измерения (как в MAX31865_Get_Code())
+
+	Reading->Code = (uint16_t) (((Rx[0] << 8) | Rx[1]) >> 1);
+	Reading->Status = (Rx[1] & 0x01) ? Rx[6] : 0;
+	Reading->Timestamp = PWM_Sync_Edge;
+	MAX31865_Fault_status = Reading->Status;
+	if (Reading->Status) {
+		TRACE_EVENT(TRACE_FAULT, 0);
+		PWM_Sync_Stats.Faults++;
+		uint8_t Write[2] = { 0x80, PWM_Sync_Config | 0x02 }; //Сброс ошибки, 1-shot остается
+		NSS_ON;
+		CMSIS_SPI_Data_Transmit_8BIT(SPI1, Write, 2, 10);
+		NSS_OFF;
+	}
+
+	PWM_Sync_Arm();
+	return true;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Совпадение TIM3 CH2: запуск 1-shot
+ *  @attention Разрешено только между PWM_Sync_Arm() и запуском. Опоздание от совпадения
+ *  (вход в прерывание, вытеснение аварией) - в PWM_Sync_Stats.Late_max.
+ *  Нагреватель выключается (OC1 force inactive) до записи 1-shot и остается выключенным до
+ *  PWM_Sync_Take_Sample() - в окне преобразования нет фронтов ключа.
+ *  SPI - опросом регистров с пределом по DWT (PWM_SYNC_SPI_TIMEOUT_CYCLES), Timeout_counter_ms
+ *  не трогается. Запись не прошла - ШИМ возвращается, прерывание остается разрешенным,
+ *  запуск в следующем периоде.
+ **************************************************************************************************
+ */
+void TIM3_IRQHandler(void) {
+	uint16_t Late = (uint16_t) ((TIM3->CNT + HEATER_PWM_PERIOD - TIM3->CCR2) % HEATER_PWM_PERIOD);
+	CLEAR_BIT(TIM3->SR, TIM_SR_CC2IF);
+	if (PWM_Sync_Converting) {
+		CLEAR_BIT(TIM3->DIER, TIM_DIER_CC2IE);
+		return;
+	}
+
+	uint8_t Write[2] = { 0x80, PWM_Sync_Config | 0x20 }; //Бит 1-shot
+	uint8_t Rx[2];
+	MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_OC1M_Msk, PWM_SYNC_OC1M_OFF << TIM_CCMR1_OC1M_Pos); //Нагреватель выключен на время преобразования
+	NSS_ON;
+	bool Ok = CMSIS_SPI_Data_Exchange_8BIT_cycles(SPI1, Write, Rx, 2, PWM_SYNC_SPI_TIMEOUT_CYCLES);
+	NSS_OFF;
+	if (!Ok) {
+		MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_OC1M_Msk, PWM_SYNC_OC1M_PWM << TIM_CCMR1_OC1M_Pos);
+		PWM_Sync_Stats.SPI_errors++;
+		return;
+	}
+	PWM_Sync_Edge = Clock_Now(); //Преобразование стартует по фронту CS
+	PWM_Sync_Converting = true;
+	CLEAR_BIT(TIM3->DIER, TIM_DIER_CC2IE); //Один запуск на постановку
+
+	PWM_Sync_Stats.Triggers++;
+	if (Late > PWM_Sync_Stats.Late_max) {
+		PWM_Sync_Stats.Late_max = Late;
+	}
+}
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ *  @file reading.c
+ *  @brief Публикация измерений по каналам без разрывов (seqlock с двумя копиями)
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. reading.h
+ ******************************************************************************
+ */
+
+#include "reading.h"
+#if defined (__arm__)
+#include <stm32f1xx.h>
+#else
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST) //Сборка на ПК (host/replay.c)
+#endif
+
+static struct Reading_Slot Reading_Table[CHANNEL_COUNT];
+
+/*
+ **************************************************************************************************
+ *  @breif Публикация нового измерения канала
+ *  @attention Писатель у канала должен быть один (основной цикл или одно прерывание).
+ *  Поле Sequence записи заполняется здесь.
+ *  @param  Channel - номер канала
+ *  @param  *Reading - измерение
+ *  @retval Номер публикации (Sequence опубликованной записи)
+ **************************************************************************************************
+ */
+uint32_t Reading_Publish(uint8_t Channel, const struct Reading* Reading) {
+	struct Reading_Slot* Slot = &Reading_Table[Channel];
+	uint32_t Sequence = Slot->Sequence;
+
+	Slot->Sequence = Sequence + 1; //Нечетный: читатели берут копию 1
+	__DMB();
+	Slot->Copy[0] = *Reading;
+	Slot->Copy[0].Sequence = Sequence / 2 + 1;
+	__DMB();
+	Slot->Sequence = Sequence + 2; //Четный: читатели берут копию 0 (уже новую)
+	__DMB();
+	Slot->Copy[1] = Slot->Copy[0];
+	__DMB();
+	return Sequence / 2 + 1;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Снимок последнего измерения канала
+ *  @attention Можно вызывать из любого контекста, в том числе из прерываний.
+ *  @param  Channel - номер канала
+ *  @param  *Reading - куда скопировать измерение
+ *  @retval true - снимок получен, false - канал еще не публиковался
+ **************************************************************************************************
+ */
+bool Reading_Get(uint8_t Channel, struct Reading* Reading) {
+	const struct Reading_Slot* Slot = &Reading_Table[Channel];
+	uint32_t Sequence;
+
+	do {
+		Sequence = Slot->Sequence;
+		__DMB();
+		*Reading = Slot->Copy[Sequence & 1];
+		__DMB();
+	} while (Slot->Sequence != Sequence);
+
+	return Reading->Sequence != 0;
+}
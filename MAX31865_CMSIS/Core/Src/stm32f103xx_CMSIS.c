@@ -20,6 +20,8 @@
  */
 
 #include "stm32f103xx_CMSIS.h"
+#include "profiler.h"
+#include "trace.h"
 
  /*================================= НАСТРОЙКА DEBUG ============================================*/
 
@@ -571,6 +573,7 @@ void Delay_ms(uint32_t Milliseconds) {
  ******************************************************************************
  */
 void SysTick_Handler(void) {
+	PROFILER_BEGIN(PROFILER_SYSTICK_IRQ);
 
 	SysTimer_ms++;
 
@@ -580,6 +583,59 @@ void SysTick_Handler(void) {
 	if (Timeout_counter_ms) {
 		Timeout_counter_ms--;
 	}
+#if defined (USE_TRACE)
+	if (SysTimer_ms % TRACE_SYNC_PERIOD_MS == 0) {
+		TRACE_EVENT(TRACE_SYNC, 0); //Метка для восстановления полного времени в декодере
+	}
+#endif
+	PROFILER_END(PROFILER_SYSTICK_IRQ);
+}
+
+
+/*========================= НАСТРОЙКА СЧЕТЧИКА ТАКТОВ DWT ==============================*/
+
+/**
+ ***************************************************************************************
+ *  @breif Запуск счетчика тактов ядра DWT->CYCCNT
+ *  Счетчик 32 битный, считает такты ядра (на 72MHz переполняется примерно раз в 59.6 с),
+ *  поэтому интервалы считаем разностью (uint32_t)(t2 - t1) - переполнение так не мешает.
+ *  Уже запущенный счетчик не обнуляется: его зовут несколько модулей, а Clock_Now()
+ *  (clock_manager.h) помнит отметку счетчика с Clock_Init().
+ *  PM0056 Cortex®-M3 programming manual, ARMv7-M ARM п. C1.8 Data Watchpoint and Trace unit
+ ***************************************************************************************
+ */
+void CMSIS_DWT_Cycle_Counter_init(void) {
+	SET_BIT(CoreDebug->DEMCR, CoreDebug_DEMCR_TRCENA_Msk); //Включим блок трассировки (DWT, ITM)
+	if (!READ_BIT(DWT->CTRL, DWT_CTRL_CYCCNTENA_Msk)) {
+		DWT->CYCCNT = 0; //Обнулим счетчик
+		SET_BIT(DWT->CTRL, DWT_CTRL_CYCCNTENA_Msk); //Запустим счетчик тактов
+	}
+}
+
+
+/**
+ ***************************************************************************************
+ *  @breif Вывод трассировки ITM через SWO (PB3 / TRACESWO)
+ *  CMSIS_Debug_init() оставляет только SWD; здесь дополнительно включается асинхронный
+ *  вывод SWO (NRZ) и стимул-порты ITM. PB3 при этом занимает трассировка.
+ *  Reference Manual/см. п. 31.17 TPIU, п. 31.16.3 Debug MCU configuration register (DBGMCU_CR)
+ *  @param  SWO_Baud - скорость SWO, бит/с (частота SYSCLK / SWO_Baud должна быть целой)
+ *  @param  Ports - маска разрешенных стимул-портов ITM (бит n - порт n)
+ ***************************************************************************************
+ */
+void CMSIS_SWO_init(uint32_t SWO_Baud, uint32_t Ports) {
+	SET_BIT(CoreDebug->DEMCR, CoreDebug_DEMCR_TRCENA_Msk); //Включим блок трассировки (DWT, ITM)
+	MODIFY_REG(DBGMCU->CR, DBGMCU_CR_TRACE_MODE, 0b00 << DBGMCU_CR_TRACE_MODE_Pos); //Асинхронный режим (только SWO)
+	SET_BIT(DBGMCU->CR, DBGMCU_CR_TRACE_IOEN); //Выведем трассировку на ножку TRACESWO
+
+	TPI->SPPR = 2; //Протокол SWO: NRZ (UART)
+	TPI->ACPR = (72000000 / SWO_Baud) - 1; //Делитель скорости SWO (SYSCLK = 72MHz, см. CMSIS_RCC_SystemClock_72MHz)
+	TPI->FFCR = 0x100; //Форматтер выключен (TrigIn остается включенным)
+
+	ITM->LAR = 0xC5ACCE55; //Разблокируем запись в регистры ITM
+	ITM->TCR = (1 << ITM_TCR_TraceBusID_Pos) | ITM_TCR_SWOENA_Msk | ITM_TCR_SYNCENA_Msk | ITM_TCR_ITMENA_Msk;
+	ITM->TPR = 0; //Стимул-порты доступны и из непривилегированного кода
+	ITM->TER = Ports; //Разрешим нужные стимул-порты
 }
 
 
@@ -1541,6 +1597,7 @@ void CMSIS_USART2_Init(void) {
  */
 
 __WEAK void USART1_IRQHandler(void) {
+	PROFILER_BEGIN(PROFILER_USART1_IRQ);
 	if (READ_BIT(USART1->SR, USART_SR_RXNE)) {
 		//Если пришли данные по USART
 		husart1.rx_buffer[husart1.rx_counter] = USART1->DR; //Считаем данные в соответствующую ячейку в rx_buffer
@@ -1552,6 +1609,7 @@ __WEAK void USART1_IRQHandler(void) {
 		husart1.rx_len = husart1.rx_counter; //Узнаем, сколько байт получили
 		husart1.rx_counter = 0; //сбросим счетчик приходящих данных
 	}
+	PROFILER_END(PROFILER_USART1_IRQ);
 }
 
 
@@ -2372,7 +2430,7 @@ void CMSIS_SPI1_init(void) {
 	 * 110: fPCLK/128
 	 * 111: fPCLK/256
 	 * */
-	MODIFY_REG(SPI1->CR1, SPI_CR1_BR, 0b011 << SPI_CR1_BR_Pos); //fPCLK/4. 72000000/32 = 2.22 MBits/s
+	MODIFY_REG(SPI1->CR1, SPI_CR1_BR, 0b011 << SPI_CR1_BR_Pos); //fPCLK/16. 72000000/16 = 4.5 MBits/s (SPI1 на APB2). Подбор под линию - MAX31865_SPI_Tune()
 	SET_BIT(SPI1->CR1, SPI_CR1_CPOL); //Полярность
 	SET_BIT(SPI1->CR1, SPI_CR1_CPHA); //Фаза
 	CLEAR_BIT(SPI1->CR1, SPI_CR1_DFF); //0: 8-bit data frame format is selected for transmission/reception
@@ -2414,6 +2472,29 @@ void CMSIS_SPI1_init(void) {
 	MODIFY_REG(GPIOA->CRL, GPIO_CRL_CNF7, 0b10 << GPIO_CRL_CNF7_Pos); //Alternate Function output Push-pull 
 }
 
+/**
+ **************************************************************************************************
+ *  @breif Смена делителя частоты SCK на ходу
+ *  @attention BR можно менять только при выключенном SPI, поэтому ждем окончания передачи,
+ *  выключаем SPE, меняем BR и включаем обратно. CS в этот момент должен быть поднят.
+ *  @param  *SPI - шина SPI
+ *  @param  Prescaler - BR[2:0]: 0 - fPCLK/2 ... 7 - fPCLK/256
+ *  @retval  Возвращает статус. True - Успешно. False - шина не освободилась.
+ **************************************************************************************************
+ */
+bool CMSIS_SPI_Set_Prescaler(SPI_TypeDef* SPI, uint8_t Prescaler, uint32_t Timeout_ms) {
+	Timeout_counter_ms = Timeout_ms;
+	while (READ_BIT(SPI->SR, SPI_SR_BSY)) {
+		if (!Timeout_counter_ms) {
+			return false;
+		}
+	}
+	CLEAR_BIT(SPI->CR1, SPI_CR1_SPE);
+	MODIFY_REG(SPI->CR1, SPI_CR1_BR, (Prescaler & 0b111) << SPI_CR1_BR_Pos);
+	SET_BIT(SPI->CR1, SPI_CR1_SPE);
+	return true;
+}
+
 /**
  **************************************************************************************************
  *  @breif Функция передачи данных по шине SPI
@@ -2423,7 +2504,7 @@ void CMSIS_SPI1_init(void) {
  *  @retval  Возвращает статус передачи. True - Успешно. False - Ошибка.
  **************************************************************************************************
  */
-bool CMSIS_SPI_Data_Transmit_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms) {
+RAMFUNC bool CMSIS_SPI_Data_Transmit_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms) {
 	//(см. Reference Manual стр. 712 Transmit-only procedure (BIDIMODE=0 RXONLY=0))
 	if (!READ_BIT(SPI->SR, SPI_SR_BSY)) {
 		//Проверим занятость шины
@@ -2523,7 +2604,7 @@ bool CMSIS_SPI_Data_Transmit_16BIT(SPI_TypeDef* SPI, uint16_t* data, uint16_t Si
  *  @retval  Возвращает статус приема. True - Успешно. False - Ошибка.
  **************************************************************************************************
  */
-bool CMSIS_SPI_Data_Receive_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms) {
+RAMFUNC bool CMSIS_SPI_Data_Receive_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_data, uint32_t Timeout_ms) {
 	if (!READ_BIT(SPI->SR, SPI_SR_BSY)) {
 		//Проверим занятость шины
         
@@ -2561,6 +2642,58 @@ bool CMSIS_SPI_Data_Receive_8BIT(SPI_TypeDef* SPI, uint8_t* data, uint16_t Size_
 	}
 }
 
+/**
+ **************************************************************************************************
+ *  @breif Обмен по шине SPI (8 бит) с ожиданием флагов по счетчику тактов DWT - для прерываний
+ *  @attention Timeout_counter_ms не трогает: он общий с основным циклом, а в прерывании
+ *  с приоритетом выше SysTick не уменьшается. Нужен запущенный DWT->CYCCNT.
+ *  @param  *SPI - шина SPI
+ *  @param  *Tx - передаваемые байты (NULL - нули)
+ *  @param  *Rx - куда записать принятые байты (NULL - не сохранять)
+ *  @param  Size_data - сколько байт обменять
+ *  @param  Timeout_cycles - предел ожидания на весь обмен, такты ядра
+ *  @retval  Возвращает статус обмена. True - Успешно. False - Ошибка.
+ **************************************************************************************************
+ */
+RAMFUNC bool CMSIS_SPI_Data_Exchange_8BIT_cycles(SPI_TypeDef* SPI, const uint8_t* Tx, uint8_t* Rx, uint16_t Size_data, uint32_t Timeout_cycles) {
+	uint32_t Start = DWT->CYCCNT;
+
+	while (READ_BIT(SPI->SR, SPI_SR_BSY)) {
+		if (DWT->CYCCNT - Start > Timeout_cycles) {
+			return false;
+		}
+	}
+	if (READ_BIT(SPI->SR, SPI_SR_OVR) || READ_BIT(SPI->SR, SPI_SR_RXNE)) {
+		//Остатки после "transmit-only mode": чтение DR, затем SR сбрасывает RXNE и OVR
+		SPI->DR;
+		SPI->SR;
+	}
+
+	for (uint16_t i = 0; i < Size_data; i++) {
+		while (!READ_BIT(SPI->SR, SPI_SR_TXE)) {
+			if (DWT->CYCCNT - Start > Timeout_cycles) {
+				return false;
+			}
+		}
+		SPI->DR = Tx ? Tx[i] : 0;
+		while (!READ_BIT(SPI->SR, SPI_SR_RXNE)) {
+			if (DWT->CYCCNT - Start > Timeout_cycles) {
+				return false;
+			}
+		}
+		uint8_t Byte = (uint8_t) SPI->DR;
+		if (Rx) {
+			Rx[i] = Byte;
+		}
+	}
+	while (READ_BIT(SPI->SR, SPI_SR_BSY)) {
+		if (DWT->CYCCNT - Start > Timeout_cycles) {
+			return false;
+		}
+	}
+	return true;
+}
+
 /**
  **************************************************************************************************
  *  @breif Функция приема данных по шине SPI
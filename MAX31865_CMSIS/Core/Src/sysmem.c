@@ -30,6 +30,12 @@
  */
 static uint8_t *__sbrk_heap_end = NULL;
 
+/**
+ * Peak heap usage in bytes and number of refused requests (see mem_usage.h)
+ */
+uint32_t __sbrk_heap_peak = 0;
+uint32_t __sbrk_heap_failures = 0;
+
 /**
  * @brief _sbrk() allocates memory to the newlib heap and is used by malloc
  *        and others from the C library
@@ -70,11 +76,16 @@ void *_sbrk(ptrdiff_t incr)
   if (__sbrk_heap_end + incr > max_heap)
   {
     errno = ENOMEM;
+    __sbrk_heap_failures++;
     return (void *)-1;
   }
 
   prev_heap_end = __sbrk_heap_end;
   __sbrk_heap_end += incr;
+  if ((uint32_t)(__sbrk_heap_end - &_end) > __sbrk_heap_peak)
+  {
+    __sbrk_heap_peak = (uint32_t)(__sbrk_heap_end - &_end);
+  }
 
   return (void *)prev_heap_end;
 }
@@ -0,0 +1,146 @@
+/**
+ ******************************************************************************
+ *  @file autotune_sim.c
+ *  @brief Прогон релейной автонастройки (pid_autotune.c) на модели теплового объекта
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Модель: апериодическое звено первого порядка с запаздыванием (FOPDT)
+ *      tau * dT/dt = K * u(t - L) - (T - T_amb),  u = 0...1 (доля мощности)
+ *  плюс равномерный шум измерения. Автонастройка и регулятор - те же файлы, что в прошивке.
+ *  Удобно, чтобы до пусконаладки прикинуть гистерезис, амплитуду реле и длительность.
+ *
+ *  ./autotune_sim [K_degC] [tau_s] [L_s] [noise_degC] [sample_ms]
+ *  По умолчанию: 200 °C на 100% мощности, tau = 120 с, L = 8 с, шум 0.05 °C, опрос 200 мс.
+ *
+ *  Проверка: у FOPDT под реле с гистерезисом предельный цикл считается точно
+ *  (экспоненты между порогами SP +- eps плюс запаздывание), отсюда ожидаемые Tu и
+ *  размах, а по ним - Ku той же формулой, что в pid_autotune.c. Снятые Tu и Ku должны
+ *  совпасть в пределах TOLERANCE_TU / TOLERANCE_KU, иначе код возврата 1 (make check).
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "pid_autotune.h"
+
+#define PWM_PERIOD   1000 //Как HEATER_PWM_PERIOD в heater_control.h
+#define T_AMBIENT    25.0
+#define SETPOINT     5000 //50.00 °C
+#define DELAY_MAX    4096
+#define TOLERANCE_TU 0.05 //Допуск Tu относительно предельного цикла модели
+#define TOLERANCE_KU 0.10 //Допуск Ku (шум измерения смещает пики)
+
+static double Plant_K, Plant_tau, Plant_L, Plant_noise;
+static double Plant_T = T_AMBIENT;
+static double Delay_line[DELAY_MAX];
+static unsigned Delay_len, Delay_pos;
+
+//Шаг модели объекта на dt секунд. Возвращает измерение в 0.01 °C
+static int32_t Plant_Step(int32_t Output, double dt) {
+	double u = (double) Output / PWM_PERIOD;
+	Delay_line[Delay_pos] = u;
+	Delay_pos = (Delay_pos + 1) % Delay_len;
+	double u_delayed = Delay_line[Delay_pos];
+	Plant_T += dt / Plant_tau * (Plant_K * u_delayed - (Plant_T - T_AMBIENT));
+	double Noise = Plant_noise * (2.0 * rand() / RAND_MAX - 1.0);
+	return (int32_t) ((Plant_T + Noise) * 100.0);
+}
+
+//Предельный цикл модели под реле: Tu (с) и амплитуда (°C, половина размаха)
+static void Plant_Limit_Cycle(const struct PID_Autotune* AT, double dt, double* Tu_s, double* a_degC) {
+	double L = (Delay_len - 1) * dt + dt; //Линия задержки плюс шаг до реакции реле
+	double High = T_AMBIENT + Plant_K * (AT->Output_bias + AT->Output_step) / PWM_PERIOD;
+	double Low = T_AMBIENT + Plant_K * (AT->Output_bias - AT->Output_step) / PWM_PERIOD;
+	double On = (AT->Setpoint + AT->Hysteresis) / 100.0;
+	double Off = (AT->Setpoint - AT->Hysteresis) / 100.0;
+
+	double T_min = Low + (Off - Low) * exp(-L / Plant_tau); //После включения еще L остывает
+	double Rise = Plant_tau * log((High - T_min) / (High - On));
+	double T_max = High + (On - High) * exp(-L / Plant_tau); //После выключения еще L греется
+	double Fall = Plant_tau * log((T_max - Low) / (Off - Low));
+	*Tu_s = 2.0 * L + Rise + Fall;
+	*a_degC = (T_max - T_min) / 2.0;
+}
+
+int main(int argc, char** argv) {
+	Plant_K = argc > 1 ? atof(argv[1]) : 200.0;
+	Plant_tau = argc > 2 ? atof(argv[2]) : 120.0;
+	Plant_L = argc > 3 ? atof(argv[3]) : 8.0;
+	Plant_noise = argc > 4 ? atof(argv[4]) : 0.05;
+	uint32_t Sample_ms = argc > 5 ? (uint32_t) atoi(argv[5]) : 200;
+	double dt = Sample_ms / 1000.0;
+
+	Delay_len = (unsigned) (Plant_L / dt) + 1;
+	if (Delay_len >= DELAY_MAX) {
+		fprintf(stderr, "dead time too long for sample period\n");
+		return 1;
+	}
+	srand(1);
+
+	struct PID_Autotune AT = { 0 };
+	AT.Setpoint = SETPOINT;
+	AT.Hysteresis = (int32_t) (Plant_noise * 100.0 * 2.0) + 1;
+	AT.Output_bias = PWM_PERIOD / 2;
+	AT.Output_step = PWM_PERIOD / 2;
+	AT.Sample_period_ms = Sample_ms;
+	AT.Timeout_ms = 4UL * 60UL * 60UL * 1000UL;
+	AT.Rule = PID_AUTOTUNE_TYREUS_LUYBEN;
+
+	uint32_t Time_ms = 0;
+	int32_t Measurement = Plant_Step(0, dt);
+	PID_Autotune_Start(&AT, Time_ms);
+	while (AT.State == PID_AUTOTUNE_RELAY) {
+		int32_t Output = PID_Autotune_Step(&AT, Measurement, Time_ms);
+		Measurement = Plant_Step(Output, dt);
+		Time_ms += Sample_ms;
+	}
+	if (AT.State != PID_AUTOTUNE_DONE) {
+		printf("autotune FAILED after %.1f s\n", Time_ms / 1000.0);
+		return 1;
+	}
+	printf("autotune done in %.1f s: Tu = %.2f s, a = %.2f degC, Ku = %.3f ticks/0.01degC\n", Time_ms / 1000.0, AT.Tu_ms / 1000.0, AT.Amplitude / 100.0, AT.Ku);
+	printf("gains (Q16.16): Kp = %ld, Ki = %ld, Kd = %ld\n", (long) AT.Kp, (long) AT.Ki, (long) AT.Kd);
+
+	double Tu_s, a_degC;
+	Plant_Limit_Cycle(&AT, dt, &Tu_s, &a_degC);
+	double a = a_degC * 100.0;
+	double eps = AT.Hysteresis;
+	double Ku = 4.0 * AT.Output_step / (3.14159265358979 * sqrt(a * a - eps * eps));
+	double Tu_error = fabs(AT.Tu_ms / 1000.0 - Tu_s) / Tu_s;
+	double Ku_error = fabs(AT.Ku - Ku) / Ku;
+	printf("plant limit cycle: Tu = %.2f s (%+.1f%%), a = %.2f degC, Ku = %.3f (%+.1f%%)\n", Tu_s, 100.0 * (AT.Tu_ms / 1000.0 - Tu_s) / Tu_s, a_degC, Ku,
+			100.0 * (AT.Ku - Ku) / Ku);
+	if (Tu_error > TOLERANCE_TU || Ku_error > TOLERANCE_KU) {
+		printf("autotune FAILED: identified Tu/Ku outside tolerance (%.0f%% / %.0f%%)\n", 100.0 * TOLERANCE_TU, 100.0 * TOLERANCE_KU);
+		return 1;
+	}
+
+	//Проверка замкнутого контура: скачок уставки на +10 °C
+	struct PID_Controller PID;
+	PID_Init(&PID, 0, 0, 0, 0, PWM_PERIOD, 0);
+	PID.Setpoint = SETPOINT;
+	PID_Autotune_Apply(&AT, &PID, Measurement);
+	for (uint32_t i = 0; i < 600000 / Sample_ms; i++) {
+		Measurement = Plant_Step(PID_Compute(&PID, Measurement), dt);
+	}
+	PID.Setpoint = SETPOINT + 1000;
+	int32_t Peak = Measurement;
+	double Settle_s = -1.0;
+	for (uint32_t i = 0; i < 1200000 / Sample_ms; i++) {
+		Measurement = Plant_Step(PID_Compute(&PID, Measurement), dt);
+		if (Measurement > Peak) {
+			Peak = Measurement;
+		}
+		int32_t Error = Measurement - PID.Setpoint;
+		if (Error > 20 || Error < -20) {
+			Settle_s = -1.0;
+		} else if (Settle_s < 0.0) {
+			Settle_s = i * dt;
+		}
+	}
+	printf("step +10 degC: overshoot = %.2f degC, settled (+-0.2 degC) after %.1f s\n", (Peak - PID.Setpoint) / 100.0, Settle_s);
+	return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ * Отчет сборки: ОЗУ на канал в таблицах каналов (channel_table.h).
+ * Все таблицы состоят только из целых и float фиксированной ширины, поэтому
+ * размеры на ПК (gcc x86-64) совпадают с arm-none-eabi.
+ *
+ *   make channel_report CHANNELS=8
+ */
+
+#include <stdio.h>
+#include "channel_table.h"
+#include "reading.h"
+#include "fault_log.h"
+
+int main(void) {
+	unsigned Table = (unsigned) CHANNEL_TABLE_ROW_BYTES;
+	unsigned Slot = (unsigned) sizeof(struct Reading_Slot);
+	unsigned Faults = (unsigned) (MAX31865_FAULT_COUNT * sizeof(uint16_t));
+	unsigned Per_channel = Table + Slot + Faults;
+
+	printf("channels            %u\n", (unsigned) CHANNEL_COUNT);
+	printf("channel_table       %3u B/channel (sizeof %u)\n", Table, (unsigned) sizeof(struct Channel_Table));
+	printf("reading slot        %3u B/channel (struct Reading %u x2 + sequence)\n", Slot, (unsigned) sizeof(struct Reading));
+	printf("fault counters      %3u B/channel\n", Faults);
+	printf("total               %3u B/channel, %u B of %u budget\n", Per_channel, Per_channel * CHANNEL_COUNT, (unsigned) CHANNEL_RAM_BUDGET);
+	return 0;
+}
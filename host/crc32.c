@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ *  @file crc32.c
+ *  @brief CRC-32 файлов так же, как блок CRC STM32F103 (MAX31865/crc32.h)
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Для сверки CRC кадров, блоков журнала и записей калибровки, снятых с МК.
+ *  Расчет - CRC32_Soft() из прошивки, тот же исходник.
+ *
+ *  ./crc32 file [file ...]
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include "crc32.h"
+
+int main(int argc, char** argv) {
+	static uint8_t Buffer[1 << 16];
+	int Status = 0;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s file [file ...]\n", argv[0]);
+		return 2;
+	}
+	for (int i = 1; i < argc; i++) {
+		FILE* File = fopen(argv[i], "rb");
+		if (!File) {
+			perror(argv[i]);
+			Status = 1;
+			continue;
+		}
+		uint32_t Crc = CRC32_INIT;
+		size_t Size;
+		while ((Size = fread(Buffer, 1, sizeof(Buffer), File)) > 0) {
+			Crc = CRC32_Soft(Crc, Buffer, (uint32_t) Size); //Продолжение корректно: полные куски кратны 4
+		}
+		fclose(File);
+		printf("%08X  %s\n", (unsigned) Crc, argv[i]);
+	}
+	return Status;
+}
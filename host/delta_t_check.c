@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ *  @file delta_t_check.c
+ *  @brief Проверка наклона мК/код разности температур (delta_t.c) по опубликованным температурам
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  delta_t.c вычитает калиброванные коды пары (Pipeline_Delta_code_Q8()) и переводит
+ *  разность в мК через наклон в средней точке (Pipeline_mK_per_code_Q16()). Здесь та
+ *  же целочисленная арифметика, что в Delta_T_Update(), сравнивается с разностью
+ *  температур Pipeline_Publish() двух каналов с разной калибровкой (множитель и
+ *  смещение): неучтенная калибровка одного из каналов дает ошибку в сотни мК.
+ *  По всему диапазону кодов и для разностей до DELTA_T_STEP_CODES.
+ *  Расхождение больше TOLERANCE_MK + TOLERANCE_REL * |ΔT| - код возврата 1 (make check).
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pipeline.h"
+#include "channel_table.h"
+
+#define SLOPE_STEP    0.5   //Как DELTA_T_SLOPE_STEP в delta_t.c
+#define CAL_A_MULT    1.03f //Калибровка канала a (0): R = R_raw * mult + add
+#define CAL_A_ADD_OHM 0.4f
+#define CAL_B_MULT    0.99f //Калибровка канала b (1)
+#define CAL_B_ADD_OHM -0.25f
+#define TOLERANCE_MK  2.0   //Округление Q16 и >> 24
+#define TOLERANCE_REL 0.002 //Кривизна Pt385: при разной калибровке каналов разность до десятков °C
+
+volatile uint32_t SysTimer_ms; //В прошивке - stm32f103xx_CMSIS.c (fault_log.c)
+
+/*
+ **************************************************************************************************
+ *  @breif Температура кода через тракт прошивки
+ **************************************************************************************************
+ */
+static double Published_degC(uint8_t Channel, uint16_t Code) {
+	struct Reading Reading = { .Code = Code, .Status = 0, .Timestamp = 0 };
+
+	Pipeline_Publish(Channel, &Reading);
+	return Reading.Temperature;
+}
+
+int main(void) {
+	static const int32_t Deltas[] = { 1, 7, 20, 40 }; //Коды, до DELTA_T_STEP_CODES
+	double Error_max = 0.0;
+	unsigned Failed = 0;
+
+	Channel_Table_Init();
+	Channel_Set_Calibration(0, CAL_A_MULT, CAL_A_ADD_OHM, MAX31865_R_REF);
+	Channel_Set_Calibration(1, CAL_B_MULT, CAL_B_ADD_OHM, MAX31865_R_REF);
+
+	for (int32_t Code_b = 2000; Code_b <= 30000; Code_b += 1000) {
+		for (unsigned i = 0; i < sizeof(Deltas) / sizeof(Deltas[0]); i++) {
+			int32_t Code_a = Code_b + Deltas[i];
+			uint32_t Cal_a = Channel_Calibrated_Code_Q15(0, (uint16_t) Code_a); //Как в Delta_T_Update()
+			uint32_t Cal_b = Channel_Calibrated_Code_Q15(1, (uint16_t) Code_b);
+			int32_t Mean_code = (int32_t) (((uint64_t) Cal_a + Cal_b) >> 16);
+			int32_t mK_per_code_Q16 = Pipeline_mK_per_code_Q16(Mean_code, SLOPE_STEP);
+			int32_t Delta_Q8 = Pipeline_Delta_code_Q8(0, (uint16_t) Code_a, 1, (uint16_t) Code_b);
+			int32_t Delta_mK = (int32_t) (((int64_t) Delta_Q8 * mK_per_code_Q16) >> 24); //Как Delta_raw_mK
+			double Expected_mK = (Published_degC(0, (uint16_t) Code_a) - Published_degC(1, (uint16_t) Code_b)) * 1000.0;
+			double Error = Delta_mK - Expected_mK;
+
+			if (Error < 0.0) {
+				Error = -Error;
+			}
+			if (Error > Error_max) {
+				Error_max = Error;
+			}
+			if (Error > TOLERANCE_MK + TOLERANCE_REL * (Expected_mK < 0.0 ? -Expected_mK : Expected_mK)) {
+				printf("code %ld/%ld: delta %ld mK, published %.1f mK\n", (long) Code_a, (long) Code_b, (long) Delta_mK, Expected_mK);
+				Failed++;
+			}
+		}
+	}
+
+	printf("delta_t: gain %.2f/%.2f, offset %.2f/%.2f ohm, max error %.2f mK, %u failed\n", (double) CAL_A_MULT, (double) CAL_B_MULT,
+			(double) CAL_A_ADD_OHM, (double) CAL_B_ADD_OHM, Error_max, Failed);
+	return Failed ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+Декодер трассировки ITM/SWO прошивки (MAX31865/trace.h).
+
+На вход - сырой поток SWO (NRZ, без форматтера TPIU), например снятый OpenOCD:
+    tpiu config internal swo.bin uart off 72000000 2000000
+
+Из потока выбираются 32-битные пакеты стимул-порта TRACE_ITM_PORT, время
+восстанавливается из 24 младших бит DWT->CYCCNT (по событиям TRACE_SYNC),
+события собираются в выборки (CS_ASSERT ... следующий CS_ASSERT по каналу),
+и печатается распределение задержек по этапам в тактах и микросекундах.
+
+    python3 host/itm_decode.py swo.bin [--clock 72000000] [--port 1] [--csv timeline.csv]
+"""
+
+import argparse
+import csv
+import sys
+
+# Коды событий - как в trace.h
+# (код 4 не используется: SPI к MAX31865 работает без DMA)
+SYNC, CS_ASSERT, CS_RELEASE, DRDY, UNUSED_4, CONVERSION_DONE, FAULT, ACTUATION = range(8)
+NAMES = ["sync", "cs_assert", "cs_release", "drdy", "code4", "conversion_done", "fault", "actuation"]
+
+# Этапы: (имя, событие-начало, событие-конец). Время считается внутри одной выборки.
+STAGES = [
+    ("drdy->cs", DRDY, CS_ASSERT),
+    ("spi (cs low)", CS_ASSERT, CS_RELEASE),
+    ("read->conversion", CS_RELEASE, CONVERSION_DONE),
+    ("read->actuation", CS_RELEASE, ACTUATION),
+]
+
+
+def itm_packets(data):
+    """Разбор потока ITM. Возвращает (порт, значение) для программных стимул-пакетов."""
+    i = 0
+    n = len(data)
+    overflows = 0
+    while i < n:
+        h = data[i]
+        i += 1
+        if h == 0x00:
+            # sync-пакет: нули и 0x80 в конце. 0x80 снимаем здесь, иначе его примет
+            # за пакет с продолжением ветка ниже и съест заголовок следующего пакета
+            while i < n and data[i] == 0x00:
+                i += 1
+            if i < n and data[i] == 0x80:
+                i += 1
+            continue
+        if h == 0x70:
+            overflows += 1
+            continue
+        size_bits = h & 0x03
+        if size_bits:
+            size = (1, 2, 4)[size_bits - 1]
+            payload = data[i:i + size]
+            i += size
+            if len(payload) < size:
+                break
+            if h & 0x04:
+                continue  # аппаратный пакет DWT - не наш
+            yield h >> 3, int.from_bytes(payload, "little")
+        elif h & 0x80:
+            # протокольный пакет с продолжением (локальная метка времени, extension)
+            while i < n and data[i] & 0x80:
+                i += 1
+            i += 1
+    if overflows:
+        print(f"warning: {overflows} ITM overflow packets (events lost in the trace FIFO)", file=sys.stderr)
+
+
+def events(data, port):
+    """События (время в тактах от начала записи, код, канал) с восстановлением старших бит."""
+    epoch = 0
+    last = None
+    for p, word in itm_packets(data):
+        if p != port:
+            continue
+        code = word >> 28
+        channel = (word >> 24) & 0x0F
+        t24 = word & 0xFFFFFF
+        if last is not None and t24 < last:
+            if last - t24 > (1 << 23):
+                epoch += 1 << 24  # переполнение 24 бит
+            # иначе событие из прерывания записано чуть позже - та же эпоха
+        if last is None or t24 >= last or last - t24 > (1 << 23):
+            last = t24
+        yield epoch + t24, code, channel
+
+
+def samples(evts):
+    """Группировка событий в выборки по каналу: от DRDY/CS_ASSERT до следующего."""
+    open_samples = {}
+    for t, code, ch in evts:
+        if code == SYNC:
+            continue
+        cur = open_samples.get(ch)
+        starts_new = code == DRDY or (code == CS_ASSERT and (cur is None or CS_ASSERT in cur))
+        if starts_new:
+            if cur is not None:
+                yield ch, cur
+            cur = {}
+            open_samples[ch] = cur
+        if cur is None:
+            continue
+        cur.setdefault(code, t)
+    for ch, cur in open_samples.items():
+        yield ch, cur
+
+
+def stats(values):
+    v = sorted(values)
+    k = len(v)
+    return v[0], sum(v) / k, v[k // 2], v[min(k - 1, (k * 99) // 100)], v[-1]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("swo", help="raw SWO capture file")
+    ap.add_argument("--clock", type=float, default=72e6, help="core clock, Hz (default 72 MHz)")
+    ap.add_argument("--port", type=int, default=1, help="ITM stimulus port (TRACE_ITM_PORT)")
+    ap.add_argument("--csv", help="write per-sample timeline to CSV")
+    args = ap.parse_args()
+
+    with open(args.swo, "rb") as f:
+        data = f.read()
+
+    rows = list(samples(events(data, args.port)))
+    if not rows:
+        print("no trace events found")
+        return 1
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            w = csv.writer(f)
+            w.writerow(["channel"] + NAMES[1:])
+            for ch, s in rows:
+                w.writerow([ch] + [s.get(code, "") for code in range(1, len(NAMES))])
+
+    us = 1e6 / args.clock
+    faults = sum(1 for _, s in rows if FAULT in s)
+    print(f"{len(rows)} samples, {faults} with fault")
+    print(f"{'stage':<20}{'n':>8}{'min':>10}{'mean':>10}{'p50':>10}{'p99':>10}{'max':>10}   (cycles; us in brackets)")
+    for name, a, b in STAGES:
+        d = [s[b] - s[a] for _, s in rows if a in s and b in s and s[b] >= s[a]]
+        if d:
+            mn, mean, p50, p99, mx = stats(d)
+            print(f"{name:<20}{len(d):>8}{mn:>10}{mean:>10.0f}{p50:>10}{p99:>10}{mx:>10}   [{mean * us:.1f} us mean, {mx * us:.1f} us max]")
+
+    by_ch = {}
+    for ch, s in rows:
+        if CS_ASSERT in s:
+            by_ch.setdefault(ch, []).append(s[CS_ASSERT])
+    for ch, ts in sorted(by_ch.items()):
+        d = [b - a for a, b in zip(ts, ts[1:])]
+        if d:
+            mn, mean, p50, p99, mx = stats(d)
+            print(f"{'period ch' + str(ch):<20}{len(d):>8}{mn:>10}{mean:>10.0f}{p50:>10}{p99:>10}{mx:>10}   [{mean * us / 1000:.2f} ms mean]")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
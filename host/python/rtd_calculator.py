@@ -0,0 +1,97 @@
+"""
+Обертка над librtd_calculator.so (MAX31865/rtd_calculator.c) для NumPy.
+
+Расчет выполняется той же C-функцией, что и в прошивке, поэтому результаты
+совпадают с МК бит в бит (с точностью до libm). Массивы передаются в библиотеку
+по указателю, без копирования: на входе ожидается непрерывный массив float64,
+иначе он один раз приводится к нужному виду через numpy.ascontiguousarray.
+
+Пример:
+    import numpy as np
+    import rtd_calculator as rtd
+    r = np.linspace(18.52, 390.48, 1_000_000)
+    t = rtd.temperature_pt(r, rtd.PT100_R0, rtd.PT_385)
+
+Путь к библиотеке можно задать переменной окружения RTD_CALCULATOR_LIB,
+по умолчанию ищется host/librtd_calculator.so (см. host/Makefile).
+"""
+
+import ctypes
+import os
+
+import numpy as np
+from numpy.ctypeslib import ndpointer
+
+# Типы ТС (enum из rtd_calculator.h)
+PT_385 = 0
+PT_391 = 1
+M_428 = 2
+N_617 = 3
+
+# R0 (rtd_calculator.h)
+PT50_R0 = 50.0
+PT100_R0 = 100.0
+PT500_R0 = 500.0
+PT1000_R0 = 1000.0
+M50_R0 = 50.0
+M100_R0 = 100.0
+N100_R0 = 100.0
+N500_R0 = 500.0
+N1000_R0 = 1000.0
+
+_DEFAULT_LIB = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "librtd_calculator.so")
+_lib = ctypes.CDLL(os.environ.get("RTD_CALCULATOR_LIB", _DEFAULT_LIB))
+
+_IN = ndpointer(dtype=np.float64, flags="C_CONTIGUOUS")
+_OUT = ndpointer(dtype=np.float64, flags=("C_CONTIGUOUS", "WRITEABLE"))
+
+_FUNCS = {}
+for _name in ("Get_Temperature_PT", "Get_Resistance_PT",
+              "Get_Temperature_M", "Get_Resistance_M",
+              "Get_Temperature_N", "Get_Resistance_N"):
+    _f = getattr(_lib, _name + "_Buffer")
+    _f.argtypes = [_IN, _OUT, ctypes.c_uint32, ctypes.c_double, ctypes.c_uint8]
+    _f.restype = None
+    _FUNCS[_name] = _f
+
+
+def _call(name, values, r0, rtd_type, out):
+    src = np.ascontiguousarray(values, dtype=np.float64)
+    if out is None:
+        out = np.empty_like(src)
+    elif out.shape != src.shape or out.dtype != np.float64 or not out.flags.c_contiguous:
+        raise ValueError("out must be a C-contiguous float64 array of the same shape")
+    if src.size > 0xFFFFFFFF:
+        raise ValueError("too many points for one call")
+    _FUNCS[name](src.reshape(-1), out.reshape(-1), src.size, float(r0), int(rtd_type))
+    return out
+
+
+def temperature_pt(resistance, r0=PT100_R0, rtd_type=PT_385, out=None):
+    """Сопротивление -> температура, платиновые ТС (PT_385, PT_391)."""
+    return _call("Get_Temperature_PT", resistance, r0, rtd_type, out)
+
+
+def resistance_pt(temperature, r0=PT100_R0, rtd_type=PT_385, out=None):
+    """Температура -> сопротивление, платиновые ТС (PT_385, PT_391)."""
+    return _call("Get_Resistance_PT", temperature, r0, rtd_type, out)
+
+
+def temperature_m(resistance, r0=M100_R0, rtd_type=M_428, out=None):
+    """Сопротивление -> температура, медные ТС (M_428)."""
+    return _call("Get_Temperature_M", resistance, r0, rtd_type, out)
+
+
+def resistance_m(temperature, r0=M100_R0, rtd_type=M_428, out=None):
+    """Температура -> сопротивление, медные ТС (M_428)."""
+    return _call("Get_Resistance_M", temperature, r0, rtd_type, out)
+
+
+def temperature_n(resistance, r0=N100_R0, rtd_type=N_617, out=None):
+    """Сопротивление -> температура, никелевые ТС (N_617)."""
+    return _call("Get_Temperature_N", resistance, r0, rtd_type, out)
+
+
+def resistance_n(temperature, r0=N100_R0, rtd_type=N_617, out=None):
+    """Температура -> сопротивление, никелевые ТС (N_617)."""
+    return _call("Get_Resistance_N", temperature, r0, rtd_type, out)
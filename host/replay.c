@@ -0,0 +1,212 @@
+/**
+ ******************************************************************************
+ *  @file replay.c
+ *  @brief Повтор записанных кодов MAX31865 через тракт обработки прошивки на ПК
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Записанные с объекта сырые коды прогоняются через те же исходники, что и в
+ *  прошивке (pipeline.c, channel_table.c, reading.c, fault_log.c, rtd_calculator.c,
+ *  pid_controller.c): калибровка, температура, журнал ошибок, аварии в кодах,
+ *  регулятор нагревателя (канал 0), прогноз выхода за пределы. Результат совпадает с МК до бита (см. pipeline.h),
+ *  поэтому месяцы записей - это регрессионный тест и бенчмарк правок обработки.
+ *
+ *  Запись - текст, строка на измерение (строки с '#' и пустые пропускаются):
+ *      time_ms,channel,code,status
+ *  code - 15-битный код АЦП, status - регистр Fault Status.
+ *
+ *  Выход - строка на измерение:
+ *      time_ms,channel,code,status,resistance,temperature,sequence,output,trip,pre,ttl_ms
+ *  pre - предварительная авария по прогнозу, ttl_ms - прогноз до предела (пусто - не приближаемся).
+ *  float печатаются с 9 значащими цифрами - этого хватает, чтобы различить любые два float.
+ *  В stderr - итог: число измерений, скорость, срабатывания аварий и предварительных аварий, ошибки и
+ *  digest (FNV-1a по битам всех результатов) - одинаковый digest = одинаковый выход до бита.
+ *
+ *  ./replay [-b] [-s уставка_°C] [-c mult:add_ohm] [-t low:high:hyst_°C:delay]
+ *           [-p low:high_°C:horizon_s:decimation] log.csv
+ *      -b - бенчмарк: без построчного вывода
+ *      -p - прогноз (Pipeline_Trend_Step()): пределы, горизонт, выборок на точку окна
+ *  По умолчанию как в прошивке: регулятор - Pipeline_Heater_Init() (pipeline.h), уставка 50 °C, без калибровки,
+ *  аварии и прогноз выключены.
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "pipeline.h"
+#include "channel_table.h"
+#include "fault_log.h"
+#include "pid_controller.h"
+
+volatile uint32_t SysTimer_ms; //В прошивке - stm32f103xx_CMSIS.c, здесь - время из записи (fault_log.c)
+
+static struct PID_Controller PID;
+static struct Trip_Channel Trip[CHANNEL_COUNT];
+static struct Trend_Channel Trend[CHANNEL_COUNT];
+static uint64_t Digest = 0xcbf29ce484222325ULL;
+
+//FNV-1a по байтам значения
+static void Digest_Add(const void* Data, size_t Size) {
+	const uint8_t* Byte = Data;
+	for (size_t i = 0; i < Size; i++) {
+		Digest = (Digest ^ Byte[i]) * 0x100000001b3ULL;
+	}
+}
+
+int main(int argc, char** argv) {
+	float Setpoint = 50.0f;
+	float Cal_mult = 1.0f, Cal_add = 0.0f;
+	float Trip_low = 0.0f, Trip_high = 0.0f, Trip_hyst = 0.0f;
+	unsigned Trip_delay = 0;
+	bool Trip_on = false;
+	float Trend_low = 0.0f, Trend_high = 0.0f;
+	unsigned Trend_horizon = 0, Trend_decimation = 0;
+	bool Trend_on = false;
+	bool Bench = false;
+	int Option;
+
+	while ((Option = getopt(argc, argv, "bs:c:t:p:")) != -1) {
+		switch (Option) {
+		case 'b':
+			Bench = true;
+			break;
+		case 's':
+			Setpoint = strtof(optarg, NULL);
+			break;
+		case 'c':
+			if (sscanf(optarg, "%f:%f", &Cal_mult, &Cal_add) != 2) {
+				fprintf(stderr, "bad -c, expected mult:add_ohm\n");
+				return 2;
+			}
+			break;
+		case 't':
+			if (sscanf(optarg, "%f:%f:%f:%u", &Trip_low, &Trip_high, &Trip_hyst, &Trip_delay) != 4) {
+				fprintf(stderr, "bad -t, expected low:high:hyst:delay\n");
+				return 2;
+			}
+			Trip_on = true;
+			break;
+		case 'p':
+			if (sscanf(optarg, "%f:%f:%u:%u", &Trend_low, &Trend_high, &Trend_horizon, &Trend_decimation) != 4 || Trend_decimation == 0 || Trend_decimation > 255) {
+				fprintf(stderr, "bad -p, expected low:high:horizon_s:decimation (1..255)\n");
+				return 2;
+			}
+			Trend_on = true;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-b] [-s setpoint] [-c mult:add] [-t low:high:hyst:delay] [-p low:high:horizon_s:decimation] log.csv\n", argv[0]);
+			return 2;
+		}
+	}
+	if (optind >= argc) {
+		fprintf(stderr, "usage: %s [-b] [-s setpoint] [-c mult:add] [-t low:high:hyst:delay] [-p low:high:horizon_s:decimation] log.csv\n", argv[0]);
+		return 2;
+	}
+	FILE* Log = fopen(argv[optind], "r");
+	if (!Log) {
+		perror(argv[optind]);
+		return 1;
+	}
+
+	//Та же последовательность настройки, что в main.c
+	Channel_Table_Init();
+	Fault_Log_Reset();
+	for (uint8_t Channel = 0; Channel < CHANNEL_COUNT; Channel++) {
+		Channel_Set_Calibration(Channel, Cal_mult, Cal_add, MAX31865_R_REF);
+		if (Trip_on) {
+			Trip[Channel] = (struct Trip_Channel) { .Delay_on = (uint8_t) Trip_delay, .Latching = true, .On_fault = true, .Enabled = true };
+			Pipeline_Trip_Limits_degC(&Trip[Channel], Channel, Trip_low, Trip_high, Trip_hyst);
+		}
+		if (Trend_on) {
+			Trend[Channel].Decimation = (uint8_t) Trend_decimation;
+			Trend[Channel].Ticks_per_ms = 1; //Timestamp - time_ms из записи
+			Pipeline_Trend_Limits_degC(&Trend[Channel], Channel, Trend_low, Trend_high, Trend_horizon);
+			Trend[Channel].Enabled = true;
+		}
+	}
+	Pipeline_Heater_Init(&PID, Pipeline_Centi_degC(Setpoint)); //Как Heater_Control_init()
+
+	char Line[128];
+	unsigned long Records = 0, Bad = 0, Trips = 0, Pre_alarms = 0, Faults = 0;
+	struct timespec Start, End;
+	clock_gettime(CLOCK_MONOTONIC, &Start);
+
+	if (!Bench) {
+		printf("time_ms,channel,code,status,resistance,temperature,sequence,output,trip,pre,ttl_ms\n");
+	}
+	while (fgets(Line, sizeof(Line), Log)) {
+		char* Cursor = Line;
+		while (*Cursor == ' ' || *Cursor == '\t') {
+			Cursor++;
+		}
+		if (*Cursor == '#' || *Cursor == '\n' || *Cursor == '\r' || *Cursor == 0) {
+			continue;
+		}
+		char* Next;
+		unsigned long Time = strtoul(Cursor, &Next, 10);
+		unsigned long Channel = (*Next == ',') ? strtoul(Next + 1, &Next, 10) : ~0UL;
+		unsigned long Code = (*Next == ',') ? strtoul(Next + 1, &Next, 10) : ~0UL;
+		unsigned long Status = (*Next == ',') ? strtoul(Next + 1, &Next, 0) : ~0UL;
+		if (Channel >= CHANNEL_COUNT || Code > 0x7FFF || Status > 0xFF) {
+			Bad++;
+			continue;
+		}
+
+		SysTimer_ms = (uint32_t) Time;
+		struct Reading Reading = { .Code = (uint16_t) Code, .Status = (uint8_t) Status, .Timestamp = (uint32_t) Time };
+		Pipeline_Publish((uint8_t) Channel, &Reading);
+
+		bool Was_tripped = Trip[Channel].Tripped;
+		bool Tripped = Pipeline_Trip_Step(&Trip[Channel], Reading.Code, Reading.Status);
+		Trips += Tripped && !Was_tripped;
+		bool Was_pre = Trend[Channel].Pre_alarm;
+		bool Pre = Pipeline_Trend_Step(&Trend[Channel], &Reading); //Как в MAX31865_Publish()
+		Pre_alarms += Pre && !Was_pre;
+		Faults += Reading.Status != 0;
+
+		int32_t Output = -1;
+		if (Channel == 0) {
+			int32_t Measurement = Pipeline_Centi_degC(Reading.Temperature);
+			if (Reading.Status != 0) {
+				PID_Set_Manual(&PID, 0); //Ошибка датчика - нагреватель выключен, как в heater_control.c
+				Output = 0;
+			} else {
+				if (!PID.Automatic) {
+					PID_Set_Automatic(&PID, Measurement); //Первое измерение или снятие ошибки - безударный переход
+				}
+				Output = PID_Compute(&PID, Measurement);
+			}
+		}
+
+		Digest_Add(&Reading.Resistance, sizeof(Reading.Resistance));
+		Digest_Add(&Reading.Temperature, sizeof(Reading.Temperature));
+		Digest_Add(&Output, sizeof(Output));
+		Digest_Add(&Tripped, sizeof(Tripped));
+		if (Trend_on) {
+			Digest_Add(&Pre, sizeof(Pre)); //Без -p digest как раньше
+			Digest_Add(&Trend[Channel].Time_to_limit_ms, sizeof(Trend[Channel].Time_to_limit_ms));
+		}
+		Records++;
+
+		if (!Bench) {
+			printf("%lu,%lu,%lu,%lu,%.9g,%.9g,%u,%d,%d,%d,", Time, Channel, Code, Status, (double) Reading.Resistance, (double) Reading.Temperature,
+					(unsigned) Reading.Sequence, (int) Output, (int) Tripped, (int) Pre);
+			if (Trend[Channel].Time_to_limit_ms != UINT32_MAX) {
+				printf("%u", (unsigned) Trend[Channel].Time_to_limit_ms);
+			}
+			putchar('\n');
+		}
+	}
+	fclose(Log);
+
+	clock_gettime(CLOCK_MONOTONIC, &End);
+	double Seconds = (double) (End.tv_sec - Start.tv_sec) + (double) (End.tv_nsec - Start.tv_nsec) * 1e-9;
+	fprintf(stderr, "records %lu (bad %lu), %.3f s, %.0f records/s\n", Records, Bad, Seconds, Seconds > 0 ? Records / Seconds : 0.0);
+	fprintf(stderr, "trips %lu, pre-alarms %lu, fault samples %lu, fault log total %u\n", Trips, Pre_alarms, Faults, (unsigned) Fault_Log.Total);
+	fprintf(stderr, "digest %016llx\n", (unsigned long long) Digest);
+	return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ *  @file ring_stress.c
+ *  @brief Нагрузочная проверка кольца sample_ring.c: писатель и читатель в двух потоках
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Тот же sample_ring.c, что в прошивке (на ПК барьеры - атомарные acquire/release).
+ *  Писатель (как прерывание DRDY) кладет записи с номером подряд, на полном кольце
+ *  повторяет; читатель (как основной цикл) забирает их и проверяет:
+ *  - номера идут подряд, без пропусков и повторов;
+ *  - все поля записи согласованы с номером (рваная запись - несовпадение);
+ *  - Overflows равен числу отказов Push у писателя.
+ *  Кольцо маленькое (SAMPLE_RING_SIZE из sample_ring.h), поэтому за прогон оно много
+ *  раз и пустеет, и заполняется. Любое несовпадение - код возврата 1 (make check).
+ *  Гонки ловятся, когда потоки идут на разных ядрах (ожидание - активное); на одном
+ *  ядре потоки сменяются через sched_yield() и проверяется только логика индексов.
+ *
+ *  ./ring_stress [записей]   (по умолчанию RECORDS_DEFAULT)
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "sample_ring.h"
+
+#define RECORDS_DEFAULT 1000000UL
+
+static struct Sample_Ring Ring;
+static unsigned long Records;
+static unsigned long Push_failed; //Отказов Push (кольцо полно) - пишет только писатель
+static bool Yield; //Одно ядро: ждать через sched_yield(), иначе поток ждет конца кванта
+
+/*
+ **************************************************************************************************
+ *  @breif Запись с номером Sequence: каждое поле выводится из номера
+ **************************************************************************************************
+ */
+static void Record_Make(uint32_t Sequence, uint8_t* Channel, struct Reading* Reading) {
+	*Channel = (uint8_t) (Sequence % 7);
+	Reading->Code = (uint16_t) (Sequence & 0x7FFF);
+	Reading->Status = (uint8_t) (Sequence * 31);
+	Reading->Resistance = (float) (Sequence & 0xFFFF);
+	Reading->Temperature = (float) (Sequence >> 16);
+	Reading->Timestamp = ~Sequence;
+	Reading->Sequence = Sequence;
+}
+
+static void* Writer(void* Argument) {
+	(void) Argument;
+	for (unsigned long i = 0; i < Records; i++) {
+		uint8_t Channel;
+		struct Reading Reading;
+		Record_Make((uint32_t) i, &Channel, &Reading);
+		while (!Sample_Ring_Push(&Ring, Channel, &Reading)) {
+			Push_failed++;
+			if (Yield) {
+				sched_yield();
+			}
+		}
+	}
+	return NULL;
+}
+
+int main(int argc, char** argv) {
+	Records = (argc > 1) ? strtoul(argv[1], NULL, 0) : RECORDS_DEFAULT;
+	Yield = sysconf(_SC_NPROCESSORS_ONLN) < 2;
+	Sample_Ring_Init(&Ring);
+
+	pthread_t Thread;
+	if (pthread_create(&Thread, NULL, Writer, NULL) != 0) {
+		perror("pthread_create");
+		return 2;
+	}
+
+	unsigned long Mismatches = 0;
+	unsigned long Empty = 0;
+	for (unsigned long Expected = 0; Expected < Records;) {
+		uint8_t Channel;
+		struct Reading Reading;
+		if (!Sample_Ring_Pop(&Ring, &Channel, &Reading)) {
+			Empty++;
+			if (Yield) {
+				sched_yield();
+			}
+			continue;
+		}
+
+		uint8_t Channel_ref;
+		struct Reading Reading_ref;
+		Record_Make((uint32_t) Expected, &Channel_ref, &Reading_ref);
+		bool Same = Channel == Channel_ref && Reading.Code == Reading_ref.Code && Reading.Status == Reading_ref.Status
+				&& Reading.Resistance == Reading_ref.Resistance && Reading.Temperature == Reading_ref.Temperature
+				&& Reading.Timestamp == Reading_ref.Timestamp && Reading.Sequence == Reading_ref.Sequence;
+		if (!Same) {
+			if (Mismatches < 10) {
+				printf("record %lu: got sequence %u code %u timestamp %08x\n", Expected, (unsigned) Reading.Sequence, (unsigned) Reading.Code,
+						(unsigned) Reading.Timestamp);
+			}
+			Mismatches++;
+		}
+		if (Reading.Sequence < Expected) {
+			printf("ring_stress: sequence went back to %u at %lu\n", (unsigned) Reading.Sequence, Expected);
+			return 1; //Повтор - писатель может так и не дописать, не ждем его
+		}
+		Expected = (unsigned long) Reading.Sequence + 1; //После пропуска - дальше от полученного номера
+	}
+	pthread_join(Thread, NULL);
+
+	uint8_t Channel;
+	struct Reading Reading;
+	bool Extra = Sample_Ring_Pop(&Ring, &Channel, &Reading);
+	bool Overflows_ok = Ring.Overflows == Push_failed;
+
+	printf("ring_stress: %lu records, ring %u, high water %u, full %lu, empty %lu, mismatches %lu%s%s\n", Records, (unsigned) SAMPLE_RING_SIZE,
+			(unsigned) Ring.High_water, Push_failed, Empty, Mismatches, Extra ? ", extra record" : "", Overflows_ok ? "" : ", overflows differ");
+	return (Mismatches || Extra || !Overflows_ok) ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+/**
+ ******************************************************************************
+ *  @file max31865_rtd.c
+ *  @brief MAX31865 для Zephyr: Sensor API поверх rtd_calculator.c
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Описание см. max31865_rtd.h.
+ ******************************************************************************
+ */
+
+#define DT_DRV_COMPAT maxim_max31865_rtd
+
+#include "max31865_rtd.h"
+#include "rtd_calculator.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(max31865_rtd, CONFIG_SENSOR_LOG_LEVEL);
+
+/*
+ **************************************************************************************************
+ *  @breif Чтение регистров MAX31865 подряд
+ *  @param  reg - адрес первого регистра
+ *  @param  *buf - куда
+ *  @param  len - сколько
+ *  @retval 0 или ошибка SPI
+ **************************************************************************************************
+ */
+int max31865_rtd_reg_read(const struct device* dev, uint8_t reg, uint8_t* buf, size_t len) {
+	const struct max31865_rtd_config* cfg = dev->config;
+	const struct spi_buf tx_buf = { .buf = &reg, .len = 1 };
+	const struct spi_buf_set tx = { .buffers = &tx_buf, .count = 1 };
+	const struct spi_buf rx_buf[2] = { { .buf = NULL, .len = 1 }, { .buf = buf, .len = len } }; //Байт адреса пропускаем
+	const struct spi_buf_set rx = { .buffers = rx_buf, .count = 2 };
+
+	return spi_transceive_dt(&cfg->bus, &tx, &rx);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запись регистра MAX31865
+ *  @param  reg - адрес
+ *  @param  value - значение
+ *  @retval 0 или ошибка SPI
+ **************************************************************************************************
+ */
+int max31865_rtd_reg_write(const struct device* dev, uint8_t reg, uint8_t value) {
+	const struct max31865_rtd_config* cfg = dev->config;
+	uint8_t Write[2] = { reg | MAX31865_REG_WRITE, value };
+	const struct spi_buf tx_buf = { .buf = Write, .len = sizeof(Write) };
+	const struct spi_buf_set tx = { .buffers = &tx_buf, .count = 1 };
+
+	return spi_write_dt(&cfg->bus, &tx);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Чтение последнего преобразования
+ *  @attention При ошибке датчика читается регистр ошибок, ошибка сбрасывается (авто-режим
+ *  остается) и возвращается -EIO - как MAX31865_Get_Code() в прошивке.
+ **************************************************************************************************
+ */
+static int max31865_rtd_sample_fetch(const struct device* dev, enum sensor_channel chan) {
+	const struct max31865_rtd_config* cfg = dev->config;
+	struct max31865_rtd_data* data = dev->data;
+	uint8_t Rx[2];
+	int ret;
+
+	if (chan != SENSOR_CHAN_ALL && chan != SENSOR_CHAN_AMBIENT_TEMP && chan != SENSOR_CHAN_RESISTANCE) {
+		return -ENOTSUP;
+	}
+
+	ret = max31865_rtd_reg_read(dev, MAX31865_REG_RTD_MSB, Rx, sizeof(Rx));
+	if (ret < 0) {
+		return ret;
+	}
+
+	data->code = (uint16_t) (((Rx[0] << 8) | Rx[1]) >> 1);
+	data->fault = 0;
+	if ((Rx[1] & 0x01) == 0) {
+		return 0;
+	}
+
+	ret = max31865_rtd_reg_read(dev, MAX31865_REG_FAULT, &data->fault, 1);
+	if (ret < 0) {
+		return ret;
+	}
+	if (data->fault == 0) {
+		data->fault = 0xFF; //Бит ошибки в коде есть, а в регистре уже нет - все равно ошибка
+	}
+	LOG_WRN("RTD fault 0x%02x", data->fault);
+	ret = max31865_rtd_reg_write(dev, MAX31865_REG_CONFIG, cfg->config_reg | MAX31865_CONFIG_FAULT_CLEAR);
+	return ret < 0 ? ret : -EIO;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Температура (°C) или сопротивление ТС (Ом) по последнему fetch
+ **************************************************************************************************
+ */
+static int max31865_rtd_channel_get(const struct device* dev, enum sensor_channel chan, struct sensor_value* val) {
+	const struct max31865_rtd_config* cfg = dev->config;
+	struct max31865_rtd_data* data = dev->data;
+
+	if (data->fault) {
+		return -EIO;
+	}
+
+	double Resistance = ((double) data->code * cfg->r_ref_milliohm / 1000.0) / (double) 32768.0;
+	switch (chan) {
+		case SENSOR_CHAN_AMBIENT_TEMP:
+			return sensor_value_from_double(val, Get_Temperature_PT(Resistance, cfg->r0_milliohm / 1000.0, PT_385));
+		case SENSOR_CHAN_RESISTANCE:
+			return sensor_value_from_double(val, Resistance);
+		default:
+			return -ENOTSUP;
+	}
+}
+
+static const struct sensor_driver_api max31865_rtd_api = {
+	.sample_fetch = max31865_rtd_sample_fetch,
+	.channel_get = max31865_rtd_channel_get,
+#if defined (CONFIG_MAX31865_RTD_TRIGGER)
+	.trigger_set = max31865_rtd_trigger_set,
+#endif
+};
+
+/*
+ **************************************************************************************************
+ *  @breif Авто-режим MAX31865, сброс ошибок, DRDY
+ **************************************************************************************************
+ */
+static int max31865_rtd_init(const struct device* dev) {
+	const struct max31865_rtd_config* cfg = dev->config;
+	int ret;
+
+	if (!spi_is_ready_dt(&cfg->bus)) {
+		LOG_ERR("SPI bus %s not ready", cfg->bus.bus->name);
+		return -ENODEV;
+	}
+
+	ret = max31865_rtd_reg_write(dev, MAX31865_REG_CONFIG, cfg->config_reg | MAX31865_CONFIG_FAULT_CLEAR);
+	if (ret < 0) {
+		LOG_ERR("Config write failed: %d", ret);
+		return ret;
+	}
+
+#if defined (CONFIG_MAX31865_RTD_TRIGGER)
+	if (cfg->drdy.port != NULL) {
+		ret = max31865_rtd_trigger_init(dev);
+		if (ret < 0) {
+			LOG_ERR("DRDY init failed: %d", ret);
+			return ret;
+		}
+	}
+#endif
+
+	return 0;
+}
+
+#define MAX31865_RTD_CONFIG_REG(inst)                                   \
+	(MAX31865_CONFIG_VBIAS | MAX31865_CONFIG_AUTO |                     \
+	 (DT_INST_PROP(inst, wires) == 3 ? MAX31865_CONFIG_3WIRE : 0) |     \
+	 (DT_INST_PROP(inst, filter_50hz) ? MAX31865_CONFIG_50HZ : 0))
+
+#define MAX31865_RTD_DEFINE(inst)                                                           \
+	static struct max31865_rtd_data max31865_rtd_data_##inst;                               \
+	static const struct max31865_rtd_config max31865_rtd_config_##inst = {                  \
+		.bus = SPI_DT_SPEC_INST_GET(inst, SPI_OP_MODE_MASTER | SPI_WORD_SET(8) |            \
+					    SPI_MODE_CPHA | SPI_TRANSFER_MSB, 0),                   \
+		.drdy = GPIO_DT_SPEC_INST_GET_OR(inst, drdy_gpios, {0}),                            \
+		.r_ref_milliohm = DT_INST_PROP(inst, r_ref_milliohm),                               \
+		.r0_milliohm = DT_INST_PROP(inst, r0_milliohm),                                     \
+		.config_reg = MAX31865_RTD_CONFIG_REG(inst),                                        \
+	};                                                                                      \
+	SENSOR_DEVICE_DT_INST_DEFINE(inst, max31865_rtd_init, NULL, &max31865_rtd_data_##inst,  \
+				     &max31865_rtd_config_##inst, POST_KERNEL,              \
+				     CONFIG_SENSOR_INIT_PRIORITY, &max31865_rtd_api);
+
+DT_INST_FOREACH_STATUS_OKAY(MAX31865_RTD_DEFINE)
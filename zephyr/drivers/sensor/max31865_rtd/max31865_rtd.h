@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ *  @file max31865_rtd.h
+ *  @brief MAX31865 для Zephyr: регистры, данные драйвера, API эмулятора
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Драйвер (max31865_rtd.c) отдает Sensor API:
+ *  - sensor_sample_fetch() - чтение кода RTD (регистры 0x01-0x02) и при
+ *    ошибке датчика - регистра ошибок 0x07 со сбросом (-EIO);
+ *  - sensor_channel_get(): SENSOR_CHAN_AMBIENT_TEMP - температура по
+ *    Get_Temperature_PT() (ГОСТ 6651-2009, тот же rtd_calculator.c, что в
+ *    прошивке), SENSOR_CHAN_RESISTANCE - сопротивление ТС, Ом;
+ *  - sensor_trigger_set(SENSOR_TRIG_DATA_READY) - по спаду DRDY
+ *    (max31865_rtd_trigger.c, CONFIG_MAX31865_RTD_TRIGGER).
+ *  MAX31865 работает в авто-режиме: преобразование каждые 20 мс (50 Гц) или
+ *  16.7 мс (60 Гц), fetch берет последнее готовое.
+ *
+ *  Эмулятор (max31865_rtd_emul.c, CONFIG_EMUL_MAX31865_RTD) садится на тот же
+ *  узел devicetree под zephyr,spi-emul-controller - на native_sim драйвер
+ *  работает без изменений (samples/max31865_rtd).
+ ******************************************************************************
+ */
+
+#ifndef __MAX31865_RTD_H
+#define __MAX31865_RTD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/kernel.h>
+
+/*----------Регистры MAX31865----------*/
+#define MAX31865_REG_CONFIG      0x00 //Конфигурация
+#define MAX31865_REG_RTD_MSB     0x01 //Код RTD, старший байт
+#define MAX31865_REG_RTD_LSB     0x02 //Код RTD, младший байт (бит 0 - ошибка)
+#define MAX31865_REG_FAULT       0x07 //Регистр ошибок
+#define MAX31865_REG_COUNT       8
+#define MAX31865_REG_WRITE       0x80 //Бит записи в адресе
+
+#define MAX31865_CONFIG_VBIAS       0x80 //Смещение включено
+#define MAX31865_CONFIG_AUTO        0x40 //Авто-режим
+#define MAX31865_CONFIG_1SHOT       0x20 //1-shot (самосброс)
+#define MAX31865_CONFIG_3WIRE       0x10 //3-проводная схема
+#define MAX31865_CONFIG_FAULT_CLEAR 0x02 //Сброс ошибок (самосброс)
+#define MAX31865_CONFIG_50HZ        0x01 //Фильтр 50 Гц
+/*----------Регистры MAX31865----------*/
+
+struct max31865_rtd_config {
+	struct spi_dt_spec bus;
+	struct gpio_dt_spec drdy; //Может быть не задан (port == NULL)
+	uint32_t r_ref_milliohm; //Опорный резистор, мОм
+	uint32_t r0_milliohm; //R0 ТС, мОм
+	uint8_t config_reg; //Конфигурация MAX31865 без самосбрасываемых битов
+};
+
+struct max31865_rtd_data {
+	uint16_t code; //15-битный код последнего fetch
+	uint8_t fault; //Регистр ошибок последнего fetch (0 - нет)
+#if defined (CONFIG_MAX31865_RTD_TRIGGER)
+	const struct device* dev;
+	struct gpio_callback drdy_cb;
+	struct k_work work;
+	sensor_trigger_handler_t handler;
+	const struct sensor_trigger* trigger;
+#endif
+};
+
+int max31865_rtd_reg_read(const struct device* dev, uint8_t reg, uint8_t* buf, size_t len); //Чтение len регистров подряд
+int max31865_rtd_reg_write(const struct device* dev, uint8_t reg, uint8_t value); //Запись регистра
+
+#if defined (CONFIG_MAX31865_RTD_TRIGGER)
+int max31865_rtd_trigger_init(const struct device* dev); //DRDY: вход, прерывание по спаду, работа в системной очереди
+int max31865_rtd_trigger_set(const struct device* dev, const struct sensor_trigger* trig, sensor_trigger_handler_t handler);
+#endif
+
+#if defined (CONFIG_EMUL_MAX31865_RTD)
+void max31865_rtd_emul_set_code(const struct emul* target, uint16_t code); //Код следующих преобразований
+void max31865_rtd_emul_set_fault(const struct emul* target, uint8_t fault); //Ошибка датчика (0 - снять)
+uint32_t max31865_rtd_emul_conversions(const struct emul* target); //Преобразований с начала работы
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAX31865_RTD_H */
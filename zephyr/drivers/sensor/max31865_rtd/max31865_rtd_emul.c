@@ -0,0 +1,245 @@
+/**
+ ******************************************************************************
+ *  @file max31865_rtd_emul.c
+ *  @brief Модель MAX31865 на шине zephyr,spi-emul-controller
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Регистры 0x00-0x07 с автоинкрементом адреса, как у микросхемы:
+ *  - запись конфигурации: VBIAS + авто - преобразования по таймеру каждые
+ *    20 мс (50 Гц) / 16.7 мс (60 Гц); 1-shot - одно через 62.5 / 52 мс;
+ *    сброс ошибок обнуляет регистр 0x07 и бит ошибки в коде;
+ *  - на каждом преобразовании в 0x01-0x02 кладется код из
+ *    max31865_rtd_emul_set_code() (с ошибкой из max31865_rtd_emul_set_fault() -
+ *    бит 0 и регистр 0x07), DRDY опускается;
+ *  - чтение регистра 0x02 поднимает DRDY.
+ *  DRDY - вход gpio_emul (drdy-gpios того же узла), если задан.
+ *  Таймер модели - прерывание, регистры под спин-блокировкой.
+ ******************************************************************************
+ */
+
+#define DT_DRV_COMPAT maxim_max31865_rtd
+
+#include "max31865_rtd.h"
+
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/drivers/spi_emul.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(max31865_rtd, CONFIG_SENSOR_LOG_LEVEL);
+
+struct max31865_rtd_emul_cfg {
+	struct gpio_dt_spec drdy;
+};
+
+struct max31865_rtd_emul_data {
+	const struct emul* target;
+	struct k_spinlock lock;
+	struct k_timer timer; //Преобразования
+	uint8_t regs[MAX31865_REG_COUNT];
+	uint16_t code; //Код следующих преобразований
+	uint8_t fault; //Ошибка следующих преобразований
+	uint32_t conversions;
+};
+
+/*
+ **************************************************************************************************
+ *  @breif Уровень DRDY (true - готово, ножка в 0)
+ **************************************************************************************************
+ */
+static void max31865_rtd_emul_drdy(const struct emul* target, bool Ready) {
+	const struct max31865_rtd_emul_cfg* cfg = target->cfg;
+
+	if (cfg->drdy.port != NULL) {
+		gpio_emul_input_set(cfg->drdy.port, cfg->drdy.pin, Ready ? 0 : 1);
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Конец преобразования (из прерывания таймера)
+ **************************************************************************************************
+ */
+static void max31865_rtd_emul_convert(struct k_timer* timer) {
+	struct max31865_rtd_emul_data* data = CONTAINER_OF(timer, struct max31865_rtd_emul_data, timer);
+	k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+	uint16_t Raw = (uint16_t) ((data->code & 0x7FFF) << 1) | (data->fault ? 0x01 : 0x00);
+	data->regs[MAX31865_REG_RTD_MSB] = (uint8_t) (Raw >> 8);
+	data->regs[MAX31865_REG_RTD_LSB] = (uint8_t) Raw;
+	data->regs[MAX31865_REG_FAULT] |= data->fault;
+	data->conversions++;
+	k_spin_unlock(&data->lock, key);
+
+	max31865_rtd_emul_drdy(data->target, true);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Запись конфигурации: режим преобразований и сброс ошибок
+ *  @attention Под блокировкой data->lock
+ **************************************************************************************************
+ */
+static void max31865_rtd_emul_config(struct max31865_rtd_emul_data* data, uint8_t Value) {
+	bool Filter_50Hz = (Value & MAX31865_CONFIG_50HZ) != 0;
+
+	if (Value & MAX31865_CONFIG_FAULT_CLEAR) {
+		data->regs[MAX31865_REG_FAULT] = 0;
+		data->regs[MAX31865_REG_RTD_LSB] &= (uint8_t) ~0x01;
+	}
+	data->regs[MAX31865_REG_CONFIG] = Value & (uint8_t) ~(MAX31865_CONFIG_1SHOT | MAX31865_CONFIG_FAULT_CLEAR); //Самосбрасываемые
+
+	if ((Value & (MAX31865_CONFIG_VBIAS | MAX31865_CONFIG_AUTO)) == (MAX31865_CONFIG_VBIAS | MAX31865_CONFIG_AUTO)) {
+		k_timeout_t Period = Filter_50Hz ? K_USEC(20000) : K_USEC(16667);
+		k_timer_start(&data->timer, Period, Period);
+	} else if (Value & MAX31865_CONFIG_1SHOT) {
+		k_timer_start(&data->timer, Filter_50Hz ? K_USEC(62500) : K_USEC(52000), K_NO_WAIT);
+	} else if ((Value & MAX31865_CONFIG_AUTO) == 0) {
+		k_timer_stop(&data->timer);
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Байт номер Index в наборе буферов SPI (NULL - вне набора или буфер без данных)
+ **************************************************************************************************
+ */
+static uint8_t* max31865_rtd_emul_byte(const struct spi_buf_set* Set, size_t Index) {
+	if (Set == NULL) {
+		return NULL;
+	}
+	for (size_t i = 0; i < Set->count; i++) {
+		if (Index < Set->buffers[i].len) {
+			return Set->buffers[i].buf ? (uint8_t*) Set->buffers[i].buf + Index : NULL;
+		}
+		Index -= Set->buffers[i].len;
+	}
+	return NULL;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Один обмен при опущенном CS: байт адреса, дальше данные с автоинкрементом
+ **************************************************************************************************
+ */
+static int max31865_rtd_emul_io(const struct emul* target, const struct spi_config* config,
+				const struct spi_buf_set* tx_bufs, const struct spi_buf_set* rx_bufs) {
+	struct max31865_rtd_emul_data* data = target->data;
+	const uint8_t* Address = max31865_rtd_emul_byte(tx_bufs, 0);
+	bool Drdy_release = false;
+
+	ARG_UNUSED(config);
+	if (Address == NULL) {
+		return -EIO;
+	}
+
+	size_t Length = 0;
+	for (size_t i = 0; tx_bufs != NULL && i < tx_bufs->count; i++) {
+		Length += tx_bufs->buffers[i].len;
+	}
+	for (size_t i = 0, Rx_length = 0; rx_bufs != NULL && i < rx_bufs->count; i++) {
+		Rx_length += rx_bufs->buffers[i].len;
+		Length = MAX(Length, Rx_length);
+	}
+
+	bool Write = (*Address & MAX31865_REG_WRITE) != 0;
+	uint8_t Reg = *Address & (uint8_t) ~MAX31865_REG_WRITE;
+	k_spinlock_key_t key = k_spin_lock(&data->lock);
+	for (size_t i = 1; i < Length; i++, Reg = (Reg + 1) % MAX31865_REG_COUNT) {
+		if (Write) {
+			const uint8_t* Tx = max31865_rtd_emul_byte(tx_bufs, i);
+			if (Tx == NULL) {
+				break;
+			}
+			if (Reg == MAX31865_REG_CONFIG) {
+				max31865_rtd_emul_config(data, *Tx);
+			} else if (Reg >= 0x03 && Reg <= 0x06) {
+				data->regs[Reg] = *Tx; //Пороги; код и регистр ошибок только на чтение
+			}
+		} else {
+			uint8_t* Rx = max31865_rtd_emul_byte(rx_bufs, i);
+			if (Rx != NULL) {
+				*Rx = data->regs[Reg];
+			}
+			if (Reg == MAX31865_REG_RTD_LSB) {
+				Drdy_release = true;
+			}
+		}
+	}
+	k_spin_unlock(&data->lock, key);
+
+	if (Drdy_release) {
+		max31865_rtd_emul_drdy(target, false);
+	}
+	return 0;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Код следующих преобразований
+ **************************************************************************************************
+ */
+void max31865_rtd_emul_set_code(const struct emul* target, uint16_t code) {
+	struct max31865_rtd_emul_data* data = target->data;
+	k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+	data->code = code;
+	k_spin_unlock(&data->lock, key);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Ошибка датчика для следующих преобразований (0 - снять)
+ **************************************************************************************************
+ */
+void max31865_rtd_emul_set_fault(const struct emul* target, uint8_t fault) {
+	struct max31865_rtd_emul_data* data = target->data;
+	k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+	data->fault = fault;
+	k_spin_unlock(&data->lock, key);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Преобразований с начала работы
+ **************************************************************************************************
+ */
+uint32_t max31865_rtd_emul_conversions(const struct emul* target) {
+	struct max31865_rtd_emul_data* data = target->data;
+
+	return data->conversions;
+}
+
+static struct spi_emul_api max31865_rtd_emul_api = {
+	.io = max31865_rtd_emul_io,
+};
+
+/*
+ **************************************************************************************************
+ *  @breif Состояние после включения: регистры 0, преобразований нет, DRDY поднят
+ **************************************************************************************************
+ */
+static int max31865_rtd_emul_init(const struct emul* target, const struct device* parent) {
+	struct max31865_rtd_emul_data* data = target->data;
+
+	ARG_UNUSED(parent);
+	data->target = target;
+	memset(data->regs, 0, sizeof(data->regs));
+	data->conversions = 0;
+	k_timer_init(&data->timer, max31865_rtd_emul_convert, NULL);
+	max31865_rtd_emul_drdy(target, false);
+	return 0;
+}
+
+#define MAX31865_RTD_EMUL(inst)                                                             \
+	static struct max31865_rtd_emul_data max31865_rtd_emul_data_##inst;                     \
+	static const struct max31865_rtd_emul_cfg max31865_rtd_emul_cfg_##inst = {              \
+		.drdy = GPIO_DT_SPEC_INST_GET_OR(inst, drdy_gpios, {0}),                            \
+	};                                                                                      \
+	EMUL_DT_INST_DEFINE(inst, max31865_rtd_emul_init, &max31865_rtd_emul_data_##inst,       \
+			    &max31865_rtd_emul_cfg_##inst, &max31865_rtd_emul_api, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(MAX31865_RTD_EMUL)
@@ -0,0 +1,114 @@
+/**
+ ******************************************************************************
+ *  @file max31865_rtd_trigger.c
+ *  @brief MAX31865 для Zephyr: SENSOR_TRIG_DATA_READY по спаду DRDY
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Прерывание GPIO только ставит работу в системную очередь - SPI из
+ *  прерывания в Zephyr не читают. Обработчик пользователя зовется из
+ *  очереди и обычно сам делает sensor_sample_fetch().
+ *  DRDY снимается чтением кода RTD: если обработчик не читает датчик,
+ *  следующего спада не будет (так же ведет себя и сам MAX31865).
+ ******************************************************************************
+ */
+
+#include "max31865_rtd.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(max31865_rtd, CONFIG_SENSOR_LOG_LEVEL);
+
+/*
+ **************************************************************************************************
+ *  @breif Спад DRDY (из прерывания)
+ **************************************************************************************************
+ */
+static void max31865_rtd_drdy_callback(const struct device* port, struct gpio_callback* cb, gpio_port_pins_t pins) {
+	struct max31865_rtd_data* data = CONTAINER_OF(cb, struct max31865_rtd_data, drdy_cb);
+
+	ARG_UNUSED(port);
+	ARG_UNUSED(pins);
+	k_work_submit(&data->work);
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Вызов обработчика пользователя (системная очередь работ)
+ **************************************************************************************************
+ */
+static void max31865_rtd_work_handler(struct k_work* work) {
+	struct max31865_rtd_data* data = CONTAINER_OF(work, struct max31865_rtd_data, work);
+	sensor_trigger_handler_t handler = data->handler;
+
+	if (handler != NULL) {
+		handler(data->dev, data->trigger);
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Установка (handler != NULL) или снятие обработчика готовности
+ **************************************************************************************************
+ */
+int max31865_rtd_trigger_set(const struct device* dev, const struct sensor_trigger* trig, sensor_trigger_handler_t handler) {
+	const struct max31865_rtd_config* cfg = dev->config;
+	struct max31865_rtd_data* data = dev->data;
+	uint8_t Rx[2];
+
+	if (cfg->drdy.port == NULL) {
+		return -ENOTSUP;
+	}
+	if (trig->type != SENSOR_TRIG_DATA_READY) {
+		return -ENOTSUP;
+	}
+	if (trig->chan != SENSOR_CHAN_ALL && trig->chan != SENSOR_CHAN_AMBIENT_TEMP && trig->chan != SENSOR_CHAN_RESISTANCE) {
+		return -ENOTSUP;
+	}
+
+	int ret = gpio_pin_interrupt_configure_dt(&cfg->drdy, GPIO_INT_DISABLE);
+	if (ret < 0) {
+		return ret;
+	}
+	data->handler = handler;
+	data->trigger = trig;
+	if (handler == NULL) {
+		return 0;
+	}
+
+	ret = gpio_pin_interrupt_configure_dt(&cfg->drdy, GPIO_INT_EDGE_TO_ACTIVE);
+	if (ret < 0) {
+		return ret;
+	}
+	//DRDY мог упасть, пока прерывание было выключено - тогда спада уже не будет. Чтение кода его снимает
+	if (gpio_pin_get_dt(&cfg->drdy) > 0) {
+		ret = max31865_rtd_reg_read(dev, MAX31865_REG_RTD_MSB, Rx, sizeof(Rx));
+	}
+	return ret;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif DRDY: вход, обратный вызов GPIO, работа
+ **************************************************************************************************
+ */
+int max31865_rtd_trigger_init(const struct device* dev) {
+	const struct max31865_rtd_config* cfg = dev->config;
+	struct max31865_rtd_data* data = dev->data;
+
+	if (!gpio_is_ready_dt(&cfg->drdy)) {
+		LOG_ERR("DRDY port %s not ready", cfg->drdy.port->name);
+		return -ENODEV;
+	}
+
+	int ret = gpio_pin_configure_dt(&cfg->drdy, GPIO_INPUT);
+	if (ret < 0) {
+		return ret;
+	}
+
+	data->dev = dev;
+	k_work_init(&data->work, max31865_rtd_work_handler);
+	gpio_init_callback(&data->drdy_cb, max31865_rtd_drdy_callback, BIT(cfg->drdy.pin));
+	return gpio_add_callback(cfg->drdy.port, &data->drdy_cb);
+}
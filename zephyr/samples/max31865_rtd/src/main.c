@@ -0,0 +1,213 @@
+/**
+ ******************************************************************************
+ *  @file main.c
+ *  @brief MAX31865 на native_sim: проверка драйвера на эмуляторе и бенчмарк
+ *  @date 18.10.2026
+ ******************************************************************************
+ * @attention
+ *
+ *  Сборка и запуск (из корня репозитория, Zephyr SDK и west установлены):
+ *      west build -b native_sim zephyr/samples/max31865_rtd -- -DZEPHYR_EXTRA_MODULES=$PWD
+ *      ./build/zephyr/zephyr.exe
+ *  или twister -T zephyr/samples -p native_sim (sample.yaml).
+ *
+ *  1. Точность: по сетке -200...850 °C эмулятору задается код идеального Pt100
+ *     (Get_Resistance_PT()), драйвер должен вернуть ту же температуру с
+ *     точностью до кванта АЦП.
+ *  2. Ошибка датчика: fetch дает -EIO, после снятия ошибки - снова данные.
+ *  3. DRDY: за 1 с модельного времени обработчик готовности должен увидеть
+ *     каждое преобразование (50 Гц).
+ *  4. Бенчмарк fetch + channel_get и одного Get_Temperature_PT() по часам ПК
+ *     (на native_sim модельное время на вычислениях стоит).
+ ******************************************************************************
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "max31865_rtd.h"
+#include "rtd_calculator.h"
+
+#if defined (CONFIG_ARCH_POSIX)
+#include <native_rtc.h>
+#endif
+
+#define RTD_NODE DT_NODELABEL(rtd0)
+#define R_REF (DT_PROP(RTD_NODE, r_ref_milliohm) / 1000.0)
+#define R0 (DT_PROP(RTD_NODE, r0_milliohm) / 1000.0)
+
+#define ACCURACY_STEP_DEGC 10 //Шаг сетки проверки точности, °C
+#define ACCURACY_LIMIT_DEGC 0.05 //Допуск: полкванта АЦП (Rref / 65536) на крутизне Pt100 у 850 °C
+#define TRIGGER_WINDOW_MS 1000 //Окно проверки DRDY
+#define BENCH_ITERATIONS 100000
+
+static const struct device* const rtd = DEVICE_DT_GET(RTD_NODE);
+static const struct emul* const rtd_emul = EMUL_DT_GET(RTD_NODE);
+
+/*
+ **************************************************************************************************
+ *  @breif Время ПК, мкс (для бенчмарка)
+ **************************************************************************************************
+ */
+static uint64_t Bench_now_us(void) {
+#if defined (CONFIG_ARCH_POSIX)
+	return native_rtc_gettime_us(RTC_CLOCK_REALTIME);
+#else
+	return k_cyc_to_us_floor64(k_cycle_get_64());
+#endif
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Ожидание следующего преобразования эмулятора
+ **************************************************************************************************
+ */
+static void Wait_conversion(void) {
+	uint32_t Start = max31865_rtd_emul_conversions(rtd_emul);
+	while (max31865_rtd_emul_conversions(rtd_emul) == Start) {
+		k_msleep(1);
+	}
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Код идеального Pt100 по сетке температур -> температура драйвера
+ **************************************************************************************************
+ */
+static int Check_accuracy(void) {
+	double Error_max = 0.0;
+
+	for (int Temperature = -200; Temperature <= 850; Temperature += ACCURACY_STEP_DEGC) {
+		struct sensor_value Value;
+		double Code = Get_Resistance_PT(Temperature, R0, PT_385) * 32768.0 / R_REF;
+
+		max31865_rtd_emul_set_code(rtd_emul, (uint16_t) (Code + 0.5));
+		Wait_conversion();
+		if (sensor_sample_fetch(rtd) < 0 || sensor_channel_get(rtd, SENSOR_CHAN_AMBIENT_TEMP, &Value) < 0) {
+			printf("accuracy: read failed at %d C\n", Temperature);
+			return -EIO;
+		}
+		double Error = fabs(sensor_value_to_double(&Value) - Temperature);
+		if (Error > Error_max) {
+			Error_max = Error;
+		}
+	}
+
+	printf("accuracy: -200..850 C step %d, max error %.4f C\n", ACCURACY_STEP_DEGC, Error_max);
+	return Error_max <= ACCURACY_LIMIT_DEGC ? 0 : -EINVAL;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Ошибка датчика: -EIO и сброс, затем снова данные
+ **************************************************************************************************
+ */
+static int Check_fault(void) {
+	max31865_rtd_emul_set_fault(rtd_emul, 0x04); //Перенапряжение/недонапряжение
+	Wait_conversion();
+	int Ret = sensor_sample_fetch(rtd);
+	max31865_rtd_emul_set_fault(rtd_emul, 0);
+	Wait_conversion();
+	int Ret_clear = sensor_sample_fetch(rtd);
+
+	printf("fault: fetch %d, after clear %d\n", Ret, Ret_clear);
+	return (Ret == -EIO && Ret_clear == 0) ? 0 : -EIO;
+}
+
+#if defined (CONFIG_MAX31865_RTD_TRIGGER)
+static volatile uint32_t Drdy_count;
+static volatile uint32_t Drdy_errors;
+
+/*
+ **************************************************************************************************
+ *  @breif Обработчик готовности: чтение (оно же снимает DRDY)
+ **************************************************************************************************
+ */
+static void Drdy_handler(const struct device* dev, const struct sensor_trigger* trig) {
+	struct sensor_value Value;
+
+	ARG_UNUSED(trig);
+	if (sensor_sample_fetch(dev) < 0 || sensor_channel_get(dev, SENSOR_CHAN_AMBIENT_TEMP, &Value) < 0) {
+		Drdy_errors++;
+	}
+	Drdy_count++;
+}
+
+/*
+ **************************************************************************************************
+ *  @breif Обработчик DRDY видит каждое преобразование за TRIGGER_WINDOW_MS
+ **************************************************************************************************
+ */
+static int Check_trigger(void) {
+	const struct sensor_trigger Trigger = { .type = SENSOR_TRIG_DATA_READY, .chan = SENSOR_CHAN_ALL };
+
+	Drdy_count = 0;
+	Drdy_errors = 0;
+	uint32_t Start = max31865_rtd_emul_conversions(rtd_emul);
+	int Ret = sensor_trigger_set(rtd, &Trigger, Drdy_handler);
+	if (Ret < 0) {
+		printf("trigger: set failed %d\n", Ret);
+		return Ret;
+	}
+	k_msleep(TRIGGER_WINDOW_MS);
+	sensor_trigger_set(rtd, &Trigger, NULL);
+	uint32_t Conversions = max31865_rtd_emul_conversions(rtd_emul) - Start;
+
+	printf("trigger: %u DRDY in %d ms, %u conversions, %u errors\n", Drdy_count, TRIGGER_WINDOW_MS, Conversions,
+	       Drdy_errors);
+	return (Drdy_errors == 0 && Drdy_count + 1 >= Conversions && Drdy_count > 0) ? 0 : -EIO;
+}
+#endif
+
+/*
+ **************************************************************************************************
+ *  @breif Время fetch + channel_get и одного пересчета, по часам ПК
+ **************************************************************************************************
+ */
+static void Bench(void) {
+	struct sensor_value Value;
+	volatile double Sink = 0.0;
+
+	uint64_t Start = Bench_now_us();
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		sensor_sample_fetch(rtd);
+		sensor_channel_get(rtd, SENSOR_CHAN_AMBIENT_TEMP, &Value);
+	}
+	uint64_t Fetch_us = Bench_now_us() - Start;
+
+	Start = Bench_now_us();
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		Sink += Get_Temperature_PT(100.0 + (i & 0xFF) * 0.5, R0, PT_385);
+	}
+	uint64_t Convert_us = Bench_now_us() - Start;
+
+	printf("bench: fetch+get %.3f us, Get_Temperature_PT %.3f us (%d iterations)\n",
+	       (double) Fetch_us / BENCH_ITERATIONS, (double) Convert_us / BENCH_ITERATIONS, BENCH_ITERATIONS);
+}
+
+int main(void) {
+	if (!device_is_ready(rtd)) {
+		printf("max31865_rtd: device not ready\n");
+		return 0;
+	}
+
+	int Ret = Check_accuracy();
+	if (Ret == 0) {
+		Ret = Check_fault();
+	}
+#if defined (CONFIG_MAX31865_RTD_TRIGGER)
+	if (Ret == 0) {
+		Ret = Check_trigger();
+	}
+#endif
+	if (Ret == 0) {
+		Bench();
+	}
+
+	printf("max31865_rtd: %s\n", Ret == 0 ? "PASS" : "FAIL");
+	return 0;
+}